@@ -0,0 +1,235 @@
+/*****************************************************************************
+* @file         frame.c
+* @brief        framed request throughput, pipelined requests are fed to
+*               vln_isr in 3 byte sget chunks and each is answered by an
+*               echo callback, reports frames per second and checks every
+*               answer arrived with a good crc. first checks that a foreign
+*               application string is dropped and not typed into the line
+*
+*   cc -O2 -I. -DCFG_VLN_FRAME=1 vln.c bench/frame.c -o frame
+*   ./frame
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.03.08
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "vln.h"
+
+/* private macro -----------------------------------------------------------*/
+#define FRAME_COUNT 20000
+#define FRAME_ROUNDS 10
+#define FRAME_CHUNK 3
+
+/* private variables -------------------------------------------------------*/
+static uint8_t script[FRAME_COUNT * (VLN_FRAME_OVERHEAD + 6) + 1];
+static size_t scriptlen;
+static size_t scriptpos;
+
+static uint8_t answer[FRAME_COUNT * (VLN_FRAME_OVERHEAD + 7) + 64]; /*!< and a prompt */
+static size_t answerlen;
+
+static vln_t session;
+static char linebuff[128] __attribute__((aligned(4)));
+static char framebuff[64];
+
+/* private functions -------------------------------------------------------*/
+static uint16_t sput(void *buf, uint16_t size)
+{
+    if ((answerlen + size) <= sizeof(answer)) {
+        memcpy(answer + answerlen, buf, size);
+        answerlen += size;
+    }
+
+    return size;
+}
+
+static uint16_t sget(void *buf, uint16_t size)
+{
+    size_t n = scriptlen - scriptpos;
+
+    n = n < size ? n : size;
+    n = n < FRAME_CHUNK ? n : FRAME_CHUNK;
+    memcpy(buf, script + scriptpos, n);
+    scriptpos += n;
+
+    return n;
+}
+
+static uint64_t now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*****************************************************************************
+* @brief        CRC-16/CCITT-FALSE, a bit at a time, independent of vln
+*****************************************************************************/
+static uint16_t crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xffff;
+    int i;
+
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+static uint16_t echo(void *arg, uint8_t *data, uint16_t len, uint16_t size)
+{
+    (void)arg;
+
+    if (len < size) {
+        data[len++] = '!';
+    }
+
+    return len;
+}
+
+static void request(uint8_t tag, const char *payload, uint16_t len)
+{
+    uint8_t *p = script + scriptlen;
+    uint16_t crc;
+
+    p[0] = 0x1b;
+    p[1] = '_';
+    p[2] = 'V';
+    p[3] = VLN_FRAME_REQUEST;
+    p[4] = tag;
+    p[5] = (uint8_t)(len >> 8);
+    p[6] = (uint8_t)len;
+    memcpy(p + 7, payload, len);
+
+    crc = crc16(p + 3, 4 + len);
+    p += 7 + len;
+    p[0] = (uint8_t)(crc >> 8);
+    p[1] = (uint8_t)crc;
+    p[2] = 0x1b;
+    p[3] = '\\';
+
+    scriptlen += VLN_FRAME_OVERHEAD + len;
+}
+
+/*****************************************************************************
+* @brief        count answers that are well formed responses, the prompt
+*               and other output between them is passed over
+*****************************************************************************/
+static size_t check(void)
+{
+    size_t good = 0;
+    size_t i = 0;
+    uint16_t len;
+
+    while ((i + VLN_FRAME_OVERHEAD) <= answerlen) {
+        if ((answer[i] != 0x1b) || (answer[i + 1] != '_') || (answer[i + 2] != 'V')) {
+            i++;
+            continue;
+        }
+
+        len = (answer[i + 5] << 8) | answer[i + 6];
+        if ((answer[i + 3] != VLN_FRAME_RESPONSE) || ((i + VLN_FRAME_OVERHEAD + len) > answerlen)) {
+            break;
+        }
+
+        good += crc16(answer + i + 3, 4 + len) == ((answer[i + 7 + len] << 8) | answer[i + 8 + len]);
+        i += VLN_FRAME_OVERHEAD + len;
+    }
+
+    return good;
+}
+
+/*****************************************************************************
+* @brief        an application string that is not a frame must never reach
+*               the line, keys around it and a frame behind it still do
+*****************************************************************************/
+static int foreign(void)
+{
+    static const char keys[] = "\x1b_Xhello\x1b\\ab";
+    static const char tail[] = "c\r";
+    uint32_t size = 0;
+    char *line = NULL;
+
+    scriptlen = scriptpos = 0;
+    memcpy(script, keys, sizeof(keys) - 1);
+    scriptlen = sizeof(keys) - 1;
+    request(1, "status", 6);
+    memcpy(script + scriptlen, tail, sizeof(tail) - 1);
+    scriptlen += sizeof(tail) - 1;
+    answerlen = 0;
+
+    while ((NULL == line) && (scriptpos < scriptlen)) {
+        line = vln_isr(&session, linebuff, sizeof(linebuff), &size);
+    }
+
+    printf("foreign apc  line [%.*s]  %zu answer\n", (int)size, line ? line : "", check());
+    return (NULL != line) && (size == 3) && !memcmp(line, "abc", 3) && (check() == 1);
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(void)
+{
+    vln_init_t init = { 0 };
+    uint32_t size;
+    size_t good = 0;
+    uint64_t t = 0;
+    uint64_t t0;
+    int r;
+    int i;
+
+    init.prompt = "> ";
+    init.sput = sput;
+    init.sget = sget;
+
+    vln_init(&session, &init);
+    vln_term(&session, VLN_TERM_XTERM);
+    vln_frame(&session, echo, NULL, framebuff, sizeof(framebuff));
+
+    if (!foreign()) {
+        return 1;
+    }
+
+    scriptlen = 0;
+    for (i = 0; i < FRAME_COUNT; i++) {
+        request((uint8_t)i, "status", 6);
+    }
+    script[scriptlen++] = '\r';
+
+    for (r = 0; r < FRAME_ROUNDS; r++) {
+        scriptpos = 0;
+        answerlen = 0;
+
+        t0 = now();
+        while (scriptpos < scriptlen) {
+            vln_isr(&session, linebuff, sizeof(linebuff), &size);
+        }
+        t += now() - t0;
+
+        good += check();
+    }
+
+    printf("%d requests x %d  %.2f M frames/s  %zu good answers\n", FRAME_COUNT, FRAME_ROUNDS,
+           (double)FRAME_COUNT * FRAME_ROUNDS * 1000 / t, good);
+
+    return good == (size_t)FRAME_COUNT * FRAME_ROUNDS ? 0 : 1;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
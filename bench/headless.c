@@ -0,0 +1,137 @@
+/*****************************************************************************
+* @file         headless.c
+* @brief        line intake with headless input on and off, the same stream
+*               of 63 byte lines is read in 64 byte sget chunks, reports
+*               throughput and the bytes sent back per line
+*
+*   cc -O2 -I. -DCFG_VLN_HEADLESS=1 vln.c bench/headless.c -o headless
+*   ./headless
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.03.08
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "vln.h"
+
+/* private macro -----------------------------------------------------------*/
+#define HEADLESS_LINES 200000
+#define HEADLESS_CHUNK 64
+
+/* private variables -------------------------------------------------------*/
+static const char sample[] = "set gpio 12 high; read adc 3 --avg 16 --rate 1000 # step 0001\n";
+
+static char *script;
+static size_t scriptlen;
+static size_t scriptpos;
+static size_t sent;
+
+static vln_t session;
+static char linebuff[256] __attribute__((aligned(4)));
+static char history[4096] __attribute__((aligned(4)));
+
+/* private functions -------------------------------------------------------*/
+static uint16_t sput(void *buf, uint16_t size)
+{
+    (void)buf;
+    sent += size;
+    return size;
+}
+
+static uint16_t sget(void *buf, uint16_t size)
+{
+    size_t n = scriptlen - scriptpos;
+
+    n = n < size ? n : size;
+    n = n < HEADLESS_CHUNK ? n : HEADLESS_CHUNK;
+    memcpy(buf, script + scriptpos, n);
+    scriptpos += n;
+
+    return n;
+}
+
+static uint64_t now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*****************************************************************************
+* @brief        feed the whole script, returns MB/s and the lines read
+*****************************************************************************/
+static double run(uint8_t mode, size_t *lines)
+{
+    vln_init_t init = { 0 };
+    uint32_t size;
+    uint64_t t;
+
+    init.prompt = "> ";
+    init.sput = sput;
+    init.sget = sget;
+    init.history = history;
+    init.histsize = sizeof(history);
+
+    vln_init(&session, &init);
+    vln_term(&session, VLN_TERM_XTERM);
+    vln_headless(&session, mode);
+
+    scriptpos = 0;
+    sent = 0;
+    *lines = 0;
+
+    t = now();
+    for (;;) {
+        if (NULL != vln_isr(&session, linebuff, sizeof(linebuff), &size)) {
+            (*lines)++;
+        } else if (scriptpos >= scriptlen) {
+            break;
+        }
+    }
+    t = now() - t;
+
+    return (double)scriptlen * 1000 / t;
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(void)
+{
+    size_t lines;
+    double mbs;
+    size_t i;
+
+    script = malloc(HEADLESS_LINES * (sizeof(sample) - 1));
+    if (NULL == script) {
+        return 1;
+    }
+
+    for (i = 0; i < HEADLESS_LINES; i++) {
+        memcpy(script + scriptlen, sample, sizeof(sample) - 1);
+        scriptlen += sizeof(sample) - 1;
+    }
+
+    mbs = run(VLN_HEADLESS_OFF, &lines);
+    printf("interactive  %7zu lines  %7.1f MB/s  %5.1f bytes sent/line\n",
+           lines, mbs, (double)sent / lines);
+    mbs = run(VLN_HEADLESS_ON, &lines);
+    printf("headless     %7zu lines  %7.1f MB/s  %5.1f bytes sent/line\n",
+           lines, mbs, (double)sent / lines);
+
+    free(script);
+    return 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
@@ -0,0 +1,149 @@
+#!/bin/sh
+#
+# Build vln for every combination of the CFG_VLN_* switches below at each
+# optimization level and report section sizes, worst-case stack depth and
+# the host replay cost per keystroke.
+#
+#   CC=arm-none-eabi-gcc SIZE=arm-none-eabi-size RUN=0 bench/matrix.sh
+#
+# Environment:
+#   CC        compiler                        (default: cc)
+#   SIZE      binutils size for the target    (default: size)
+#   CFLAGS    extra flags for every build
+#   OPTIONS   boolean CFG_VLN_* switches      (default: HISTORY XTERM DEBUG)
+#   LEVELS    optimization levels             (default: -Os -O2)
+#   RUN       1 to run the host replay        (default: 1)
+#   SCRIPT    keystroke script for replay     (default: built in)
+#
+# Stack depth is the deepest static call chain below the exported entry
+# points, callbacks (sput/sget) excluded.
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+CC=${CC:-cc}
+SIZE=${SIZE:-size}
+OPTIONS=${OPTIONS:-"CFG_VLN_HISTORY CFG_VLN_XTERM CFG_VLN_DEBUG"}
+LEVELS=${LEVELS:-"-Os -O2"}
+RUN=${RUN:-1}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+# deepest static call chain from vln entry points, reads gcc .ci files
+stack_depth() {
+    awk '
+    /^node:/ {
+        match($0, /title: "[^"]*"/)
+        name = substr($0, RSTART + 8, RLENGTH - 9)
+        if (match($0, /[0-9]+ bytes/)) {
+            frame[name] = substr($0, RSTART, RLENGTH) + 0
+        }
+        split(name, part, ":")
+        fn = part[length(part)]
+        if (fn ~ /^vln(_init|_detect|_clear|_mask|_sgrset|_sgrdelta|_isr)?$/) {
+            roots[name] = 1
+        }
+    }
+    /^edge:/ {
+        match($0, /sourcename: "[^"]*"/)
+        src = substr($0, RSTART + 12, RLENGTH - 13)
+        match($0, /targetname: "[^"]*"/)
+        dst = substr($0, RSTART + 12, RLENGTH - 13)
+        key = src SUBSEP dst
+        if (!(key in seen)) {
+            seen[key] = 1
+            callee[src, ++ncallee[src]] = dst
+        }
+    }
+    function depth(fn,    i, d, best) {
+        if (fn in memo) {
+            return memo[fn]
+        }
+        if (fn in onpath) {
+            return 0
+        }
+        onpath[fn] = 1
+        best = 0
+        for (i = 1; i <= ncallee[fn]; i++) {
+            d = depth(callee[fn, i])
+            if (d > best) {
+                best = d
+            }
+        }
+        delete onpath[fn]
+        memo[fn] = frame[fn] + best
+        return memo[fn]
+    }
+    END {
+        max = 0
+        for (r in roots) {
+            d = depth(r)
+            if (d > max) {
+                max = d
+            }
+        }
+        print max
+    }' "$@"
+}
+
+# sum of sections whose name starts with $2 in `size -A` output $1
+section() {
+    awk -v sec="$2" '
+    index($1, sec) == 1 && (length($1) == length(sec) || substr($1, length(sec) + 1, 1) == ".") {
+        sum += $2
+    }
+    END { print sum + 0 }' "$1"
+}
+
+set -- $OPTIONS
+count=$#
+combos=$((1 << count))
+
+printf '%-6s' "level"
+for opt in $OPTIONS; do
+    printf ' %-8s' "$(echo "$opt" | sed 's/^CFG_VLN_//' | cut -c1-8)"
+done
+printf ' %7s %7s %7s %7s' ".text" ".rodata" ".bss" "stack"
+if [ "$RUN" = 1 ]; then
+    printf ' %10s %9s' "cost/key" "bytes/key"
+fi
+printf '\n'
+
+for level in $LEVELS; do
+    mask=0
+    while [ $mask -lt $combos ]; do
+        defs=""
+        bit=0
+        printf '%-6s' "$level"
+        for opt in $OPTIONS; do
+            val=$(((mask >> bit) & 1))
+            defs="$defs -D$opt=$val"
+            printf ' %-8s' "$val"
+            bit=$((bit + 1))
+        done
+
+        obj="$OUT/vln.o"
+        rm -f "$OUT"/*.ci
+        $CC $level $CFLAGS $defs -I"$ROOT" -fcallgraph-info=su \
+            -c "$ROOT/vln.c" -o "$obj"
+        $SIZE -A "$obj" > "$OUT/size.txt"
+
+        printf ' %7s %7s %7s %7s' \
+            "$(section "$OUT/size.txt" .text)" \
+            "$(section "$OUT/size.txt" .rodata)" \
+            "$(section "$OUT/size.txt" .bss)" \
+            "$(stack_depth "$OUT"/*.ci)"
+
+        if [ "$RUN" = 1 ]; then
+            $CC $level $CFLAGS $defs -I"$ROOT" "$ROOT/bench/replay.c" "$obj" \
+                -o "$OUT/replay"
+            "$OUT/replay" $SCRIPT > "$OUT/replay.txt"
+            printf ' %10s %9s' \
+                "$(awk '{ print $6 }' "$OUT/replay.txt")" \
+                "$(awk '{ print $8 }' "$OUT/replay.txt")"
+        fi
+        printf '\n'
+
+        mask=$((mask + 1))
+    done
+done
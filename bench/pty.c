@@ -0,0 +1,491 @@
+/*****************************************************************************
+* @file         pty.c
+* @brief        line editors compared through the same pty keystroke
+*               scripts, reports bytes emitted, cpu per keystroke, peak rss
+*               and startup time, and checks every line each editor read
+*
+*   cc -O2 bench/pty.c -o pty
+*   ./pty ./ttyline_vln ./ttyline_readline ./ttyline_linenoise
+*
+* Each program is bench/ttyline.c built for one editor. It runs on an 80x24
+* pty with TERM=xterm and INPUTRC=/dev/null. Keys are typed one at a time.
+* After each key the driver reads output until the pty stays quiet for
+* -q us (300 by default), so an editor never sees keys typed ahead. Every
+* script runs in a fresh process. Its cpu time minus that of a process
+* that only showed the prompt, divided by the keys, is the cpu per
+* keystroke. Startup is the median time from fork to the prompt on the
+* pty over -n runs (20 by default).
+*
+* Scripts only use keys that mean the same in every editor: printable
+* characters, backspace, left, right, Ctrl-A, Ctrl-E, up and enter. Up
+* is used only on the newest line, because the editors differ in what
+* they keep of an edited history line.
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.03.05
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <libgen.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/* private macro -----------------------------------------------------------*/
+#define PTY_KEYS    8192 /*!< keys per script     */
+#define PTY_LINES   256  /*!< lines per script    */
+#define PTY_LINEMAX 512  /*!< line model size     */
+
+#define KEY_LEFT  "\x1b[D"
+#define KEY_RIGHT "\x1b[C"
+#define KEY_UP    "\x1b[A"
+#define KEY_HOME  "\x01"
+#define KEY_END   "\x05"
+#define KEY_BS    "\x7f"
+#define KEY_ENTER "\r"
+
+/* private types -----------------------------------------------------------*/
+typedef struct {
+    const char *name;
+    const char *key[PTY_KEYS]; /*!< keys, static strings */
+    uint32_t nkey;
+    char line[PTY_LINES][PTY_LINEMAX]; /*!< lines the keys enter */
+    uint32_t nline;
+
+    /*!< line model the keys are built with */
+    char buf[PTY_LINEMAX];
+    uint16_t len;
+    uint16_t cur;
+} script_t;
+
+typedef struct {
+    pid_t pid;
+    int master;
+    int report; /*!< read end of the line report pipe */
+} child_t;
+
+typedef struct {
+    uint64_t bytes;
+    double cpu;     /*!< seconds */
+    long rss;       /*!< KB      */
+    uint32_t good;  /*!< lines as expected */
+    uint32_t lines; /*!< lines read        */
+} result_t;
+
+/* private variables -------------------------------------------------------*/
+static script_t scripts[4];
+static uint32_t nscript;
+static long quiet_us = 300;
+static int runs = 20;
+
+/* private functions -------------------------------------------------------*/
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*****************************************************************************
+* @brief        append a key and apply it to the line model
+*****************************************************************************/
+static void key(script_t *s, const char *k)
+{
+    if (s->nkey >= PTY_KEYS) {
+        fprintf(stderr, "pty: script %s too long\n", s->name);
+        exit(1);
+    }
+    s->key[s->nkey++] = k;
+
+    if (!strcmp(k, KEY_LEFT)) {
+        s->cur -= (s->cur > 0);
+    } else if (!strcmp(k, KEY_RIGHT)) {
+        s->cur += (s->cur < s->len);
+    } else if (!strcmp(k, KEY_HOME)) {
+        s->cur = 0;
+    } else if (!strcmp(k, KEY_END)) {
+        s->cur = s->len;
+    } else if (!strcmp(k, KEY_BS)) {
+        if (s->cur > 0) {
+            memmove(s->buf + s->cur - 1, s->buf + s->cur, s->len - s->cur);
+            s->cur--;
+            s->len--;
+        }
+    } else if (!strcmp(k, KEY_UP)) {
+        /*!< newest line only */
+        s->len = s->cur = (uint16_t)strlen(s->line[s->nline - 1]);
+        memcpy(s->buf, s->line[s->nline - 1], s->len);
+    } else if (!strcmp(k, KEY_ENTER)) {
+        memcpy(s->line[s->nline], s->buf, s->len);
+        s->line[s->nline++][s->len] = '\0';
+        s->len = s->cur = 0;
+    } else {
+        memmove(s->buf + s->cur + 1, s->buf + s->cur, s->len - s->cur);
+        s->buf[s->cur++] = k[0];
+        s->len++;
+    }
+}
+
+static void type(script_t *s, const char *text)
+{
+    static const char *ascii[128];
+    static char chars[256];
+
+    for (; *text; text++) {
+        int c = *text & 0x7f;
+        if (NULL == ascii[c]) {
+            chars[c * 2] = (char)c;
+            ascii[c] = &chars[c * 2];
+        }
+        key(s, ascii[c]);
+    }
+}
+
+static void repeat(script_t *s, const char *k, int n)
+{
+    while (n-- > 0) {
+        key(s, k);
+    }
+}
+
+/*****************************************************************************
+* @brief        build the scripts
+*****************************************************************************/
+static void scripts_build(void)
+{
+    script_t *s;
+    char text[PTY_LINEMAX];
+    int i, j;
+
+    /*!< plain typing of commands */
+    s = &scripts[nscript++];
+    s->name = "type";
+    for (i = 0; i < 50; i++) {
+        snprintf(text, sizeof(text), "set port %d speed %d mode auto", i, 100 * (i % 4 + 1));
+        type(s, text);
+        key(s, KEY_ENTER);
+    }
+
+    /*!< edits in the middle of a line */
+    s = &scripts[nscript++];
+    s->name = "edit";
+    for (i = 0; i < 30; i++) {
+        snprintf(text, sizeof(text), "show interface eth%d status", i);
+        type(s, text);
+        repeat(s, KEY_LEFT, 7);
+        type(s, "link ");
+        key(s, KEY_HOME);
+        repeat(s, KEY_RIGHT, 5);
+        repeat(s, KEY_BS, 5);
+        type(s, "display");
+        key(s, KEY_END);
+        repeat(s, KEY_BS, 3);
+        type(s, "tus");
+        key(s, KEY_ENTER);
+    }
+
+    /*!< recall the newest line and extend it */
+    s = &scripts[nscript++];
+    s->name = "history";
+    type(s, "ping 10.0.0.1");
+    key(s, KEY_ENTER);
+    for (i = 0; i < 40; i++) {
+        key(s, KEY_UP);
+        snprintf(text, sizeof(text), " -c%d", i);
+        type(s, text);
+        if (i % 4 == 3) {
+            /*!< keep lines short */
+            key(s, KEY_HOME);
+            repeat(s, KEY_RIGHT, 13);
+            for (j = 0; j < 16; j++) {
+                key(s, KEY_BS);
+            }
+            key(s, KEY_END);
+        }
+        key(s, KEY_ENTER);
+    }
+
+    /*!< lines longer than the terminal, edited at both ends */
+    s = &scripts[nscript++];
+    s->name = "long";
+    for (i = 0; i < 10; i++) {
+        for (j = 0; j < 200; j++) {
+            text[j] = (char)('a' + (i + j) % 26);
+        }
+        text[j] = '\0';
+        type(s, text);
+        key(s, KEY_HOME);
+        repeat(s, KEY_RIGHT, 50);
+        type(s, "0123456789");
+        key(s, KEY_END);
+        repeat(s, KEY_BS, 5);
+        key(s, KEY_ENTER);
+    }
+}
+
+/*****************************************************************************
+* @brief        run a program on a new pty, lines go to a pipe on fd 3
+*****************************************************************************/
+static int spawn(const char *prog, child_t *c)
+{
+    struct winsize ws = { .ws_row = 24, .ws_col = 80 };
+    int pipefd[2];
+    int slave;
+
+    c->master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((c->master < 0) || grantpt(c->master) || unlockpt(c->master) ||
+        ioctl(c->master, TIOCSWINSZ, &ws) || pipe(pipefd)) {
+        perror("pty");
+        return -1;
+    }
+
+    c->pid = fork();
+    if (c->pid == 0) {
+        setsid();
+        slave = open(ptsname(c->master), O_RDWR);
+        ioctl(slave, TIOCSCTTY, 0);
+        close(c->master);
+        close(pipefd[0]);
+        dup2(slave, 0);
+        dup2(slave, 1);
+        dup2(slave, 2);
+        dup2(pipefd[1], 3);
+        if (slave > 3) {
+            close(slave);
+        }
+        if (pipefd[1] > 3) {
+            close(pipefd[1]);
+        }
+
+        setenv("TERM", "xterm", 1);
+        setenv("INPUTRC", "/dev/null", 1);
+        execl(prog, prog, (char *)NULL);
+        _exit(127);
+    }
+
+    close(pipefd[1]);
+    c->report = pipefd[0];
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        read output until the pty stays quiet for timeout
+* @retval long              bytes read, -1 once the pty is closed
+*****************************************************************************/
+static long drain(child_t *c, long timeout_us, const char *until)
+{
+    static char buf[65536];
+    struct pollfd p = { .fd = c->master, .events = POLLIN };
+    struct timespec ts;
+    long total = 0;
+    ssize_t n;
+    int seen = (NULL == until);
+    size_t matched = 0;
+
+    for (;;) {
+        ts.tv_sec = timeout_us / 1000000;
+        ts.tv_nsec = (timeout_us % 1000000) * 1000;
+        if (ppoll(&p, 1, seen ? &ts : NULL, NULL) <= 0) {
+            return total;
+        }
+
+        n = read(c->master, buf, sizeof(buf));
+        if (n <= 0) {
+            return total ? total : -1;
+        }
+        total += n;
+
+        for (ssize_t i = 0; !seen && (i < n); i++) {
+            matched = (buf[i] == until[matched]) ? matched + 1 : (buf[i] == until[0]);
+            seen = (until[matched] == '\0');
+        }
+        if (seen && until) {
+            return total;
+        }
+    }
+}
+
+/*****************************************************************************
+* @brief        close the pty and collect the child
+*****************************************************************************/
+static void finish(child_t *c, struct rusage *ru)
+{
+    close(c->master);
+    if (wait4(c->pid, NULL, 0, ru) < 0) {
+        memset(ru, 0, sizeof(*ru));
+    }
+}
+
+static double cpu(const struct rusage *ru)
+{
+    return ru->ru_utime.tv_sec + ru->ru_utime.tv_usec / 1e6 + ru->ru_stime.tv_sec +
+           ru->ru_stime.tv_usec / 1e6;
+}
+
+static int compare(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/*****************************************************************************
+* @brief        median startup time and cpu of a process showing the prompt
+*****************************************************************************/
+static int startup(const char *prog, double *ms, double *base)
+{
+    double t[64], u[64], t0;
+    struct rusage ru;
+    child_t c;
+    int i;
+
+    for (i = 0; i < runs; i++) {
+        t0 = now();
+        if (spawn(prog, &c)) {
+            return -1;
+        }
+        if (drain(&c, 0, "> ") < 0) {
+            finish(&c, &ru);
+            close(c.report);
+            return -1;
+        }
+        t[i] = (now() - t0) * 1e3;
+        finish(&c, &ru);
+        close(c.report);
+        u[i] = cpu(&ru);
+    }
+
+    qsort(t, runs, sizeof(t[0]), compare);
+    qsort(u, runs, sizeof(u[0]), compare);
+    *ms = t[runs / 2];
+    *base = u[runs / 2];
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        type a script, then check the lines the program read
+*****************************************************************************/
+static int run(const char *prog, const script_t *s, result_t *r)
+{
+    static char got[PTY_LINES * PTY_LINEMAX];
+    struct rusage ru;
+    child_t c;
+    size_t len = 0;
+    ssize_t n;
+    char *line, *next;
+    uint32_t i;
+    long bytes;
+
+    memset(r, 0, sizeof(*r));
+
+    if (spawn(prog, &c)) {
+        return -1;
+    }
+
+    bytes = drain(&c, 0, "> ");
+    for (i = 0; (bytes >= 0) && (i < s->nkey); i++) {
+        r->bytes += bytes;
+        if (write(c.master, s->key[i], strlen(s->key[i])) < 0) {
+            break;
+        }
+        bytes = drain(&c, quiet_us, NULL);
+    }
+    r->bytes += (bytes > 0) ? bytes : 0;
+
+    finish(&c, &ru);
+    r->cpu = cpu(&ru);
+    r->rss = ru.ru_maxrss;
+
+    while ((len < sizeof(got) - 1) && ((n = read(c.report, got + len, sizeof(got) - 1 - len)) > 0)) {
+        len += n;
+    }
+    got[len] = '\0';
+    close(c.report);
+
+    for (line = got; (next = strchr(line, '\n')); line = next + 1) {
+        *next = '\0';
+        if ((r->lines < s->nline) && !strcmp(line, s->line[r->lines])) {
+            r->good++;
+        }
+        r->lines++;
+    }
+
+    return 0;
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    double ms, base;
+    result_t r;
+    char *name;
+    long rss;
+    uint32_t i;
+    int opt, p;
+
+    while ((opt = getopt(argc, argv, "q:n:")) != -1) {
+        if (opt == 'q') {
+            quiet_us = atol(optarg);
+        } else if ((opt == 'n') && (atoi(optarg) > 0) && (atoi(optarg) <= 64)) {
+            runs = atoi(optarg);
+        } else {
+            fprintf(stderr, "usage: %s [-q quiet_us] [-n startup_runs] program...\n", argv[0]);
+            return 1;
+        }
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    scripts_build();
+
+    printf("%-22s %-8s %6s %6s %8s %8s %6s\n", "program", "script", "keys", "lines", "bytes",
+           "B/key", "us/key");
+
+    for (p = optind; p < argc; p++) {
+        name = basename(strdup(argv[p]));
+
+        if (access(argv[p], X_OK) || startup(argv[p], &ms, &base)) {
+            printf("%-22s not runnable, skipped\n", name);
+            continue;
+        }
+
+        rss = 0;
+        for (i = 0; i < nscript; i++) {
+            if (run(argv[p], &scripts[i], &r)) {
+                continue;
+            }
+            rss = (r.rss > rss) ? r.rss : rss;
+
+            printf("%-22s %-8s %6u %3u/%-3u %8llu %8.1f %6.1f%s\n", name, scripts[i].name,
+                   scripts[i].nkey, r.good, scripts[i].nline, (unsigned long long)r.bytes,
+                   (double)r.bytes / scripts[i].nkey,
+                   ((r.cpu > base) ? r.cpu - base : 0) * 1e6 / scripts[i].nkey,
+                   ((r.good == scripts[i].nline) && (r.lines == scripts[i].nline)) ? "" :
+                                                                                      "  LINES DIFFER");
+        }
+
+        printf("%-22s startup %.2f ms  peak rss %ld KB\n\n", name, ms, rss);
+    }
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
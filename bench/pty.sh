@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Build bench/ttyline.c for vln and for the other line editors found, then
+# compare them with bench/pty.c through the same pty keystroke scripts.
+#
+#   bench/pty.sh
+#   LINENOISE=../linenoise bench/pty.sh
+#
+# Environment:
+#   CC          compiler                                (default: cc)
+#   CFLAGS      flags for every build                   (default: -O2)
+#   VLN_CFLAGS  CFG_VLN_* switches of the vln build     (default: wrap)
+#   LINENOISE   directory with linenoise.c and .h, the linenoise build is
+#               skipped without it
+#   PTY_ARGS    extra bench/pty.c options, e.g. -q 500
+#
+# GNU readline is built when its headers and library link. linenoise is
+# not vendored, point LINENOISE at a checkout to include it.
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+VLN_CFLAGS=${VLN_CFLAGS:--DCFG_VLN_WRAP=1}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+$CC $CFLAGS -o "$OUT/pty" "$ROOT/bench/pty.c"
+
+$CC $CFLAGS $VLN_CFLAGS -I"$ROOT" -I"$ROOT/port/linux" -o "$OUT/ttyline_vln" \
+    "$ROOT/vln.c" "$ROOT/port/linux/vln_tty.c" "$ROOT/bench/ttyline.c"
+set -- "$OUT/ttyline_vln"
+
+if $CC $CFLAGS -DTTYLINE_READLINE -o "$OUT/ttyline_readline" "$ROOT/bench/ttyline.c" \
+    -lreadline 2>/dev/null; then
+    set -- "$@" "$OUT/ttyline_readline"
+else
+    echo "readline: not found, skipped"
+fi
+
+if [ -n "$LINENOISE" ]; then
+    $CC $CFLAGS -DTTYLINE_LINENOISE -I"$LINENOISE" -o "$OUT/ttyline_linenoise" \
+        "$ROOT/bench/ttyline.c" "$LINENOISE/linenoise.c"
+    set -- "$@" "$OUT/ttyline_linenoise"
+else
+    echo "linenoise: LINENOISE not set, skipped"
+fi
+
+cd "$OUT"
+# shellcheck disable=SC2086
+./pty $PTY_ARGS "$@"
@@ -0,0 +1,263 @@
+/*****************************************************************************
+* @file         replay.c
+* @brief        host side keystroke replay for vln, reports cycles and
+*               output bytes per keystroke, and per stage histograms when
+*               built with CFG_VLN_PROBE=1
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.02.25
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "vln.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define REPLAY_UNIT "cycles"
+#else
+#define REPLAY_UNIT "ns"
+#endif
+
+/* private macro -----------------------------------------------------------*/
+#ifndef REPLAY_ROUNDS
+#define REPLAY_ROUNDS 2000
+#endif
+
+/* private variables -------------------------------------------------------*/
+
+/*!< default keystroke script, every line must end with CR */
+static const char defscript[] =
+    "help\r"
+    "config show all\r"
+    "\e[A\e[A\r"
+    "set baud 115200\b\b\b\b\b\b921600\r"
+    "\x01# \x05\r"
+    "log dump --since 10m --level debug\x17\x17\r"
+    "ifconfig eth0 up\e[D\e[D\e[D\e[D\e[3~\e[3~\e[3~\e[3~\r"
+    "\e[H\e[F\e[1~\e[4~\x0b\r"
+    "reboot now\x15reset\r"
+    "\e[A\e[A\e[A\e[B\e[B\r";
+
+static const char *script = defscript;
+static size_t scriptlen = sizeof(defscript) - 1;
+static size_t scriptpos;
+static size_t outbytes;
+
+static char linebuff[256] __attribute__((aligned(4)));
+static char histbuff[1024] __attribute__((aligned(4)));
+
+/* private functions -------------------------------------------------------*/
+
+static uint16_t replay_sput(void *buf, uint16_t size)
+{
+    (void)buf;
+    outbytes += size;
+    return size;
+}
+
+static uint16_t replay_sget(void *buf, uint16_t size)
+{
+    if (size > scriptlen - scriptpos) {
+        size = scriptlen - scriptpos;
+    }
+
+    memcpy(buf, script + scriptpos, size);
+    scriptpos += size;
+    return size;
+}
+
+static uint64_t replay_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+static uint32_t replay_cycles(void)
+{
+    return (uint32_t)replay_now();
+}
+
+/*****************************************************************************
+* @brief        first bucket reaching pct percent of count
+*****************************************************************************/
+static unsigned replay_bucket(const uint32_t *hist, uint64_t count, unsigned pct)
+{
+    uint64_t sum = 0;
+    unsigned b;
+
+    for (b = 0; b < CFG_VLN_PROBE_BUCKETS - 1; b++) {
+        sum += hist[b];
+        if (sum * 100 >= count * pct) {
+            break;
+        }
+    }
+
+    return b;
+}
+
+/*****************************************************************************
+* @brief        print sample count and p50/p99 bucket bound of each stage
+*****************************************************************************/
+static void replay_probe_report(vln_t *vln)
+{
+    static const char *names[VLN_PROBE_MAX] = {
+        "parse", "edit", "hload", "hstore", "render", "output",
+    };
+    const uint32_t *hist;
+    uint64_t count;
+
+    for (uint8_t stage = 0; stage < VLN_PROBE_MAX; stage++) {
+        hist = vln_probe_hist(vln, stage);
+
+        count = 0;
+        for (unsigned b = 0; b < CFG_VLN_PROBE_BUCKETS; b++) {
+            count += hist[b];
+        }
+
+        printf("%-7s %10llu  p50 <%llu p99 <%llu %s\n", names[stage], (unsigned long long)count,
+               2ull << replay_bucket(hist, count, 50), 2ull << replay_bucket(hist, count, 99),
+               REPLAY_UNIT);
+    }
+}
+#endif
+
+/*****************************************************************************
+* @brief        count key events, an escape sequence counts as one key
+*****************************************************************************/
+static size_t replay_keys(const char *s, size_t len)
+{
+    size_t keys = 0;
+
+    for (size_t i = 0; i < len; i++, keys++) {
+        if ((s[i] != '\e') || (i + 1 >= len)) {
+            continue;
+        }
+
+        i++;
+        if ((s[i] != '[') && (s[i] != 'O')) {
+            continue;
+        }
+
+        while ((i + 1 < len) && !((s[i + 1] >= 0x40) && (s[i + 1] <= 0x7e))) {
+            i++;
+        }
+        i++;
+    }
+
+    return keys;
+}
+
+static char *replay_load(const char *path, size_t *len)
+{
+    FILE *fp = fopen(path, "rb");
+    char *buf;
+    long size;
+
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    /*!< reserve one byte for trailing CR */
+    buf = malloc(size + 1);
+    if ((buf == NULL) || (fread(buf, 1, size, fp) != (size_t)size)) {
+        fclose(fp);
+        free(buf);
+        return NULL;
+    }
+    fclose(fp);
+
+    if ((size == 0) || (buf[size - 1] != '\r')) {
+        buf[size++] = '\r';
+    }
+
+    *len = size;
+    return buf;
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    vln_t console;
+    vln_init_t init = {
+        .prompt = "\e[32mvln\e[m> ",
+        .history = histbuff,
+        .histsize = sizeof(histbuff),
+        .sput = replay_sput,
+        .sget = replay_sget,
+    };
+    uint32_t linesize;
+    uint64_t start, total;
+    size_t keys, lines;
+    unsigned rounds = REPLAY_ROUNDS;
+
+    if (argc > 1) {
+        script = replay_load(argv[1], &scriptlen);
+        if (script == NULL) {
+            fprintf(stderr, "replay: cannot read %s\n", argv[1]);
+            return 1;
+        }
+    }
+
+    if (argc > 2) {
+        rounds = (unsigned)strtoul(argv[2], NULL, 0);
+    }
+
+    if (vln_init(&console, &init)) {
+        return 1;
+    }
+
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+    vln_probe(&console, replay_cycles);
+#endif
+
+    lines = 0;
+    total = 0;
+    outbytes = 0;
+
+    for (unsigned r = 0; r < rounds; r++) {
+        scriptpos = 0;
+
+        start = replay_now();
+        while (scriptpos < scriptlen) {
+            vln(&console, linebuff, sizeof(linebuff), &linesize);
+            lines++;
+        }
+        total += replay_now() - start;
+    }
+
+    keys = replay_keys(script, scriptlen) * rounds;
+
+    printf("keys %zu lines %zu %s/key %.1f bytes/key %.2f\n",
+           keys, lines, REPLAY_UNIT,
+           (double)total / keys, (double)outbytes / keys);
+
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+    replay_probe_report(&console);
+#endif
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
@@ -0,0 +1,157 @@
+/*****************************************************************************
+* @file         ring.c
+* @brief        vln_ring stress, a producer thread writes random sized blocks
+*               of a pseudo random stream while the consumer reads it back in
+*               bulk and checks every byte, reports throughput and overrun
+*
+*   cc -O2 -pthread -I. vln_ring.c bench/ring.c -o ring && ./ring 5 256
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.02.25
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "vln_ring.h"
+
+/* private variables -------------------------------------------------------*/
+static vln_ring_t ring;
+static atomic_int running = 1;
+static uint64_t produced;
+static uint64_t consumed;
+
+/* private functions -------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        byte n of the test stream
+*****************************************************************************/
+static uint8_t stream(uint64_t n)
+{
+    n ^= n >> 7;
+    n *= 0x9e3779b97f4a7c15ull;
+    return (uint8_t)(n >> 56);
+}
+
+static void *producer(void *arg)
+{
+    uint8_t block[64];
+    uint8_t *span;
+    uint32_t seed = 1;
+    uint32_t size, n;
+
+    (void)arg;
+
+    while (atomic_load(&running)) {
+        seed = seed * 1103515245 + 12345;
+        size = 1 + (seed >> 16) % sizeof(block);
+
+        if (seed & 0x80000000) {
+            /*!< dma style, write in place */
+            n = vln_ring_wspan(&ring, &span);
+            if (n > size) {
+                n = size;
+            }
+            for (uint32_t i = 0; i < n; i++) {
+                span[i] = stream(produced + i);
+            }
+            vln_ring_commit(&ring, n);
+        } else {
+            /*!< isr style, copy a block, the tail is dropped when full */
+            for (uint32_t i = 0; i < size; i++) {
+                block[i] = stream(produced + i);
+            }
+            n = vln_ring_write(&ring, block, size);
+        }
+
+        produced += n;
+
+        /*!< ring full, let consumer run on a single core host */
+        if (n < size) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    const uint8_t *span;
+    uint8_t buf[16];
+    uint32_t n;
+
+    (void)arg;
+
+    while (atomic_load(&running)) {
+        if (consumed & 1) {
+            n = vln_ring_read(&ring, buf, sizeof(buf));
+            span = buf;
+        } else {
+            n = vln_ring_rspan(&ring, &span);
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            if (span[i] != stream(consumed + i)) {
+                fprintf(stderr, "ring: mismatch at byte %llu\n",
+                        (unsigned long long)(consumed + i));
+                exit(1);
+            }
+        }
+
+        if (span != buf) {
+            vln_ring_skip(&ring, n);
+        }
+
+        consumed += n;
+
+        if (n == 0) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    static uint8_t buf[1 << 16];
+    unsigned seconds = (argc > 1) ? (unsigned)atoi(argv[1]) : 5;
+    uint32_t size = (argc > 2) ? (uint32_t)atoi(argv[2]) : 256;
+    struct timespec delay = { .tv_sec = seconds };
+    pthread_t tp, tc;
+
+    if ((size > sizeof(buf)) || vln_ring_init(&ring, buf, size)) {
+        fprintf(stderr, "ring: size must be a power of 2 up to %zu\n", sizeof(buf));
+        return 1;
+    }
+
+    pthread_create(&tc, NULL, consumer, NULL);
+    pthread_create(&tp, NULL, producer, NULL);
+
+    nanosleep(&delay, NULL);
+    atomic_store(&running, 0);
+
+    pthread_join(tp, NULL);
+    pthread_join(tc, NULL);
+
+    printf("ring %u consumed %llu bytes %.1f MB/s overrun %u\n",
+           size, (unsigned long long)consumed,
+           consumed / 1e6 / (seconds ? seconds : 1), vln_ring_overrun(&ring));
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
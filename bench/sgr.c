@@ -0,0 +1,199 @@
+/*****************************************************************************
+* @file         sgr.c
+* @brief        bytes sent for colour heavy output, each token is coloured
+*               with vln_sgrset as set, or with vln_sgrset after a reset so
+*               no attribute is left over, or with vln_sgrdelta
+*
+*   cc -O2 -I. vln.c bench/sgr.c -o sgr
+*   ./sgr
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.03.04
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "vln.h"
+
+/* private typedef ---------------------------------------------------------*/
+typedef struct {
+    size_t text;  /*!< text bytes           */
+    size_t set;   /*!< vln_sgrset           */
+    size_t reset; /*!< reset and vln_sgrset */
+    size_t delta; /*!< vln_sgrdelta         */
+} count_t;
+
+/* private variables -------------------------------------------------------*/
+static vln_t session;
+static count_t count;
+
+/* private functions -------------------------------------------------------*/
+static uint16_t sput(void *buf, uint16_t size)
+{
+    (void)buf;
+    return size;
+}
+
+static uint16_t sget(void *buf, uint16_t size)
+{
+    (void)buf;
+    (void)size;
+    return 0;
+}
+
+static uint64_t attr(uint32_t fg, uint32_t bg, uint8_t bold, uint8_t dim)
+{
+    vln_sgr_t sgr = { .raw = 0 };
+
+    sgr.foreground = fg;
+    sgr.background = bg;
+    sgr.bold = bold;
+    sgr.dim = dim;
+
+    return sgr.raw;
+}
+
+/*****************************************************************************
+* @brief        count one token sent all three ways
+*****************************************************************************/
+static void token(uint64_t sgrraw, const char *text)
+{
+    char buf[VLN_SGR_MAX];
+    size_t idx;
+
+    idx = 0;
+    vln_sgrset(buf, &idx, sgrraw);
+    count.set += idx;
+
+    idx = 0;
+    vln_sgrset(buf, &idx, 0);
+    if (sgrraw) {
+        vln_sgrset(buf, &idx, sgrraw);
+    }
+    count.reset += idx;
+
+    idx = 0;
+    vln_sgrdelta(&session, buf, &idx, sgrraw);
+    count.delta += idx;
+
+    count.text += strlen(text);
+}
+
+/*****************************************************************************
+* @brief        ls -l with names coloured by type
+*****************************************************************************/
+static void listing(void)
+{
+    static const char *kind[4] = { "file", "dir", "exec", "link" };
+    uint64_t colour[4] = { 0, attr(VLN_SGR_BLUE, 0, 1, 0), attr(VLN_SGR_GREEN, 0, 1, 0),
+                           attr(VLN_SGR_CYAN, 0, 1, 0) };
+    uint32_t i, k;
+
+    for (i = 0; i < 500; i++) {
+        k = (i * 7 + i / 3) % 4;
+        token(0, "-rw-r--r-- 1 root root   4096 Mar  4 10:00 ");
+        token(colour[k], kind[k]);
+        token(0, "\r\n");
+    }
+}
+
+/*****************************************************************************
+* @brief        log lines, dim time, level colour, cyan keys
+*****************************************************************************/
+static void logging(void)
+{
+    static const char *level[3] = { "INFO ", "WARN ", "ERROR" };
+    uint64_t colour[3] = { attr(VLN_SGR_GREEN, 0, 0, 0), attr(VLN_SGR_YELLOW, 0, 1, 0),
+                           attr(VLN_SGR_RED, 0, 1, 0) };
+    uint32_t i, k;
+
+    for (i = 0; i < 500; i++) {
+        k = (i % 11 == 0) ? 2 : (i % 5 == 0) ? 1 : 0;
+        token(attr(0, 0, 0, 1), "10:00:00.000 ");
+        token(colour[k], level[k]);
+        token(0, " link ");
+        token(attr(VLN_SGR_CYAN, 0, 0, 0), "port=");
+        token(0, "3 ");
+        token(attr(VLN_SGR_CYAN, 0, 0, 0), "state=");
+        token(0, "up\r\n");
+    }
+}
+
+/*****************************************************************************
+* @brief        load heat map, one cell per port on a 256 colour ramp
+*****************************************************************************/
+static void heatmap(void)
+{
+    uint32_t row, col, load;
+
+    for (row = 0; row < 24; row++) {
+        for (col = 0; col < 64; col++) {
+            load = ((row * 13 + col * 7) % 40 < 30) ? (col / 16) : ((row + col) % 6);
+            token(attr(0, VLN_SGR_INDEX(196 + load * 6), 0, 0), " ");
+        }
+        token(0, "\r\n");
+    }
+}
+
+/*****************************************************************************
+* @brief        24 bit gradient, 80 cells per row
+*****************************************************************************/
+static void gradient(void)
+{
+    uint32_t row, col;
+
+    for (row = 0; row < 24; row++) {
+        for (col = 0; col < 80; col++) {
+            token(attr(VLN_SGR_RGB(col * 3, 255 - col * 3, row * 10), 0, 0, 0), "#");
+        }
+        token(0, "\r\n");
+    }
+}
+
+static void run(const char *name, void (*fn)(void))
+{
+    static const char *depth[4] = { "auto", "8", "256", "true" };
+    uint8_t colors;
+
+    for (colors = VLN_COLORS_8; colors <= VLN_COLORS_TRUE; colors++) {
+        memset(&count, 0, sizeof(count));
+        vln_colors(&session, colors);
+        fn();
+        token(0, "");
+
+        printf("%-8s %-4s text %6zu  set %6zu  reset+set %6zu  delta %6zu  %5.1f%% of reset+set\n",
+               name, depth[colors], count.text, count.set, count.reset, count.delta,
+               100.0 * (count.text + count.delta) / (count.text + count.reset));
+    }
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(void)
+{
+    vln_init_t init = { 0 };
+
+    init.prompt = "> ";
+    init.sput = sput;
+    init.sget = sget;
+
+    vln_init(&session, &init);
+    vln_term(&session, VLN_TERM_XTERM);
+
+    run("listing", listing);
+    run("logging", logging);
+    run("heatmap", heatmap);
+    run("gradient", gradient);
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
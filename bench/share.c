@@ -0,0 +1,170 @@
+/*****************************************************************************
+* @file         share.c
+* @brief        vln_share stress, writer threads append lines that encode
+*               their writer, number and length while reader threads walk
+*               the log from the newest line back like UP does, and check
+*               every line they get, reports throughput and skipped lines
+*
+*   cc -O2 -pthread -I. vln_share.c bench/share.c -o share
+*   ./share 5 4 4 4096 64       seconds writers readers arena slots
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.02.25
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "vln_share.h"
+
+/* private variables -------------------------------------------------------*/
+static vln_share_t share;
+static atomic_int running = 1;
+static _Atomic uint64_t appended;
+static _Atomic uint64_t read_ok;
+static _Atomic uint64_t missing;
+static _Atomic uint64_t gone;
+static _Atomic uint64_t corrupt;
+
+/* private functions -------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        line n of writer w, its length and tail depend on both
+*****************************************************************************/
+static uint16_t line(uint32_t w, uint32_t n, char *buf)
+{
+    uint32_t h = (w * 0x9e3779b9u) ^ (n * 0x85ebca6bu);
+    uint16_t len = (uint16_t)snprintf(buf, 24, "w%u n%u ", w, n);
+    uint16_t tail = (uint16_t)((h >> 8) % 64);
+
+    for (uint16_t i = 0; i < tail; i++) {
+        h = h * 1103515245u + 12345u;
+        buf[len++] = 'a' + (h >> 16) % 26;
+    }
+
+    return len;
+}
+
+static void *writer(void *arg)
+{
+    uint32_t w = (uint32_t)(uintptr_t)arg;
+    uint32_t n = 0;
+    char buf[96];
+    uint16_t len;
+
+    while (atomic_load(&running)) {
+        len = line(w, n++, buf);
+        vln_share_append(&share, buf, len);
+        atomic_fetch_add_explicit(&appended, 1, memory_order_relaxed);
+
+        /*!< let readers run on a single core host */
+        if ((n & 63) == 0) {
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    char got[96], want[96];
+    uint32_t seq, w, n;
+    uint16_t len;
+    uint64_t ok = 0, miss = 0, lost = 0, bad = 0;
+    int ret;
+
+    (void)arg;
+
+    while (atomic_load(&running)) {
+        seq = vln_share_next(&share);
+
+        /*!< walk back until the log no longer holds the line */
+        for (;;) {
+            ret = vln_share_read(&share, --seq, got, sizeof(got), &len);
+            if (ret < 0) {
+                lost++;
+                break;
+            }
+            if (ret > 0) {
+                miss++;
+                continue;
+            }
+
+            if ((2 != sscanf(got, "w%u n%u ", &w, &n)) || (len != line(w, n, want)) ||
+                memcmp(got, want, len)) {
+                bad++;
+                fprintf(stderr, "share: corrupt line %u: %.*s\n", seq, (int)len, got);
+            }
+            ok++;
+        }
+    }
+
+    atomic_fetch_add(&read_ok, ok);
+    atomic_fetch_add(&missing, miss);
+    atomic_fetch_add(&gone, lost);
+    atomic_fetch_add(&corrupt, bad);
+    return NULL;
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    static uint32_t buf[1 << 18];
+    static vln_share_slot_t slot[1 << 14];
+    unsigned seconds = (argc > 1) ? (unsigned)atoi(argv[1]) : 5;
+    unsigned writers = (argc > 2) ? (unsigned)atoi(argv[2]) : 4;
+    unsigned readers = (argc > 3) ? (unsigned)atoi(argv[3]) : 4;
+    uint32_t size = (argc > 4) ? (uint32_t)atoi(argv[4]) : 4096;
+    uint32_t count = (argc > 5) ? (uint32_t)atoi(argv[5]) : 64;
+    struct timespec delay = { .tv_sec = seconds };
+    pthread_t tid[128];
+    unsigned i;
+
+    if ((writers + readers > 128) || (size > sizeof(buf)) ||
+        (count > sizeof(slot) / sizeof(slot[0])) ||
+        vln_share_init(&share, buf, size, slot, count)) {
+        fprintf(stderr, "share: arena up to %zu and slots up to %zu, powers of 2\n",
+                sizeof(buf), sizeof(slot) / sizeof(slot[0]));
+        return 1;
+    }
+
+    for (i = 0; i < readers; i++) {
+        pthread_create(&tid[i], NULL, reader, NULL);
+    }
+    for (i = 0; i < writers; i++) {
+        pthread_create(&tid[readers + i], NULL, writer, (void *)(uintptr_t)i);
+    }
+
+    nanosleep(&delay, NULL);
+    atomic_store(&running, 0);
+
+    for (i = 0; i < readers + writers; i++) {
+        pthread_join(tid[i], NULL);
+    }
+
+    if (seconds == 0) {
+        seconds = 1;
+    }
+
+    printf("share %u/%u w%u r%u appended %.2f M/s read %.2f M/s missing %llu walks %llu corrupt %llu\n",
+           size, count, writers, readers, atomic_load(&appended) / 1e6 / seconds,
+           atomic_load(&read_ok) / 1e6 / seconds, (unsigned long long)atomic_load(&missing),
+           (unsigned long long)atomic_load(&gone), (unsigned long long)atomic_load(&corrupt));
+
+    return atomic_load(&corrupt) ? 1 : 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
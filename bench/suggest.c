@@ -0,0 +1,164 @@
+/*****************************************************************************
+* @file         suggest.c
+* @brief        keystroke cost of autosuggestions with a full history, each
+*               history line is typed again one key at a time with the
+*               prefix index on and off. a vt100 profile looks suggestions
+*               up but does not draw them, so the difference is the lookup
+*
+*   cc -O2 -I. -DCFG_VLN_SUGGEST=1 vln.c bench/suggest.c -o suggest
+*   ./suggest
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.03.05
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "vln.h"
+
+/* private macro -----------------------------------------------------------*/
+#define SUGGEST_MAXLINES 1024
+#define SUGGEST_ROUNDS 20
+
+/* private variables -------------------------------------------------------*/
+static const char *verbs[] = {
+    "config set net.eth", "config get net.eth", "config set sys.clock",
+    "log dump --level ",  "log tail --since ",  "ifconfig eth",
+    "show interface ",    "show route table ",
+};
+
+static char script[SUGGEST_MAXLINES * 40];
+static size_t scriptlen;
+static size_t scriptpos;
+
+static vln_t session;
+static char linebuff[128] __attribute__((aligned(4)));
+static char history[32768] __attribute__((aligned(4)));
+static vln_histidx_t histidx[SUGGEST_MAXLINES];
+
+/* private functions -------------------------------------------------------*/
+static uint16_t sput(void *buf, uint16_t size)
+{
+    (void)buf;
+    return size;
+}
+
+static uint16_t sget(void *buf, uint16_t size)
+{
+    (void)size;
+
+    if (scriptpos < scriptlen) {
+        *(char *)buf = script[scriptpos++];
+        return 1;
+    }
+
+    return 0;
+}
+
+static uint64_t now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+/*****************************************************************************
+* @brief        line n of the history, lines share long prefixes
+*****************************************************************************/
+static int line(uint32_t n, char *buf)
+{
+    return sprintf(buf, "%s%u %u", verbs[n % 8], (n / 8) % 97, n);
+}
+
+static void feed(void)
+{
+    uint32_t size;
+
+    while (scriptpos < scriptlen) {
+        vln_isr(&session, linebuff, sizeof(linebuff), &size);
+    }
+}
+
+/*****************************************************************************
+* @brief        ns per key typing every history line again, each followed
+*               by Ctrl-U instead of enter so history stays as it is
+*****************************************************************************/
+static double run(uint32_t lines, uint8_t index, size_t *keys)
+{
+    vln_init_t init = { 0 };
+    uint64_t t;
+    uint32_t i;
+    int n;
+    int r;
+
+    init.prompt = "> ";
+    init.sput = sput;
+    init.sget = sget;
+    init.history = history;
+    init.histsize = sizeof(history);
+    init.histidx = index ? histidx : NULL;
+    init.idxsize = index ? lines : 0;
+
+    vln_init(&session, &init);
+    vln_term(&session, VLN_TERM_VT100);
+
+    scriptlen = scriptpos = 0;
+    for (i = 0; i < lines; i++) {
+        scriptlen += line(i, script + scriptlen);
+        script[scriptlen++] = '\r';
+    }
+    feed();
+
+    /*!< backspace and the last key again make a lookup from scratch */
+    scriptlen = scriptpos = 0;
+    for (i = 0; i < lines; i++) {
+        n = line((i * 7919u) % lines, script + scriptlen);
+        scriptlen += n;
+        script[scriptlen++] = '\x7f';
+        script[scriptlen] = script[scriptlen - 2];
+        scriptlen++;
+        script[scriptlen++] = '\x15';
+    }
+
+    t = now();
+    for (r = 0; r < SUGGEST_ROUNDS; r++) {
+        scriptpos = 0;
+        feed();
+    }
+    t = now() - t;
+
+    *keys = scriptlen;
+    return (double)t / SUGGEST_ROUNDS / scriptlen;
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(void)
+{
+    uint32_t lines;
+    double on;
+    double off;
+    size_t keys;
+
+    for (lines = 16; lines <= SUGGEST_MAXLINES; lines *= 2) {
+        off = run(lines, 0, &keys);
+        on = run(lines, 1, &keys);
+        printf("%5u lines  %6zu keys  %6.1f ns/key off  %6.1f ns/key on  lookup %6.1f ns\n",
+               lines, keys, off, on, on - off);
+    }
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
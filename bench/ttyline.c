@@ -0,0 +1,113 @@
+/*****************************************************************************
+* @file         ttyline.c
+* @brief        line loop driven by bench/pty.c, built once per line editor.
+*               every line read is written to fd 3 when it is open, so the
+*               driver can check that each editor got the same lines
+*
+*   cc -O2 -I. -Iport/linux vln.c port/linux/vln_tty.c bench/ttyline.c -o ttyline_vln
+*   cc -O2 -DTTYLINE_READLINE bench/ttyline.c -lreadline -o ttyline_readline
+*   cc -O2 -DTTYLINE_LINENOISE -I../linenoise bench/ttyline.c ../linenoise/linenoise.c \
+*       -o ttyline_linenoise
+*
+* Each editor keeps history and adds every line that is not empty.
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.03.05
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(TTYLINE_READLINE)
+#include <readline/history.h>
+#include <readline/readline.h>
+#elif defined(TTYLINE_LINENOISE)
+#include "linenoise.h"
+#else
+#include "vln_tty.h"
+#endif
+
+/* private macro -----------------------------------------------------------*/
+#define TTYLINE_PROMPT "> "
+#define TTYLINE_REPORT 3 /*!< fd lines are written to */
+
+/* private variables -------------------------------------------------------*/
+static int report_fd = -1;
+
+/* private functions -------------------------------------------------------*/
+static void report(const char *line, size_t len)
+{
+    if (report_fd < 0) {
+        return;
+    }
+
+    if ((write(report_fd, line, len) != (ssize_t)len) || (write(report_fd, "\n", 1) != 1)) {
+        report_fd = -1;
+    }
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(void)
+{
+    char *line;
+
+    if (fcntl(TTYLINE_REPORT, F_GETFD) != -1) {
+        report_fd = TTYLINE_REPORT;
+    }
+
+#if defined(TTYLINE_READLINE)
+    while (NULL != (line = readline(TTYLINE_PROMPT))) {
+        if (*line) {
+            add_history(line);
+        }
+        report(line, strlen(line));
+        free(line);
+    }
+#elif defined(TTYLINE_LINENOISE)
+    linenoiseHistorySetMaxLen(100);
+
+    while (NULL != (line = linenoise(TTYLINE_PROMPT))) {
+        if (*line) {
+            linenoiseHistoryAdd(line);
+        }
+        report(line, strlen(line));
+        linenoiseFree(line);
+    }
+#else
+    static vln_t session;
+    static char history[4096] __attribute__((aligned(4)));
+    static char linebuff[1024] __attribute__((aligned(4)));
+    vln_init_t init = { 0 };
+    uint32_t size;
+
+    init.prompt = TTYLINE_PROMPT;
+    init.history = history;
+    init.histsize = sizeof(history);
+
+    if (vln_tty_open(&session, &init, STDIN_FILENO, STDOUT_FILENO)) {
+        return 1;
+    }
+
+    while (NULL != (line = vln_tty_line(&session, linebuff, sizeof(linebuff), &size))) {
+        report(line, size);
+    }
+
+    vln_tty_close();
+#endif
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
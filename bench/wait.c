@@ -0,0 +1,206 @@
+/*****************************************************************************
+* @file         wait.c
+* @brief        idle wait cost, a writer thread sends one key every 10 ms
+*               through a pipe while vln() runs with a poll() wait callback,
+*               or spins on sget with SPIN=1. reports the cpu used by an
+*               idle prompt and the key to echo latency. with CFG_VLN_PROMPT
+*               it also counts prompt redraws of a once a second clock
+*               placeholder while no key arrives
+*
+*   cc -O2 -pthread -I. -DCFG_VLN_PROMPT=1 vln.c bench/wait.c -o wait
+*   ./wait
+*   SPIN=1 ./wait
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.03.08
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "vln.h"
+
+/* private macro -----------------------------------------------------------*/
+#define WAIT_KEYS 500
+#define WAIT_IDLE 3 /*!< seconds of idle prompt */
+
+/* private variables -------------------------------------------------------*/
+static int fds[2];
+static atomic_int want;
+static atomic_int redraws;
+static int64_t sent;
+static int64_t lat[WAIT_KEYS];
+static int nlat;
+
+static vln_t session;
+static char linebuff[256] __attribute__((aligned(4)));
+static char history[512] __attribute__((aligned(4)));
+
+/* private functions -------------------------------------------------------*/
+static int64_t now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static double cpu(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint16_t sput(void *buf, uint16_t size)
+{
+    (void)buf;
+
+    if (atomic_load(&want)) {
+        lat[nlat++] = now() - sent;
+        atomic_store(&want, 0);
+    } else {
+        atomic_fetch_add(&redraws, 1);
+    }
+
+    return size;
+}
+
+static uint16_t sget(void *buf, uint16_t size)
+{
+    ssize_t n = read(fds[0], buf, size ? size : 1);
+
+    return n > 0 ? n : 0;
+}
+
+static uint32_t tick(void)
+{
+    return now() / 1000000;
+}
+
+static void wait_fd(uint32_t ms)
+{
+    struct pollfd p = { .fd = fds[0], .events = POLLIN };
+
+    poll(&p, 1, (ms == VLN_WAIT_FOREVER) ? -1 : (int)ms);
+}
+
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+static uint32_t shown;
+
+static uint8_t clock_poll(void *arg)
+{
+    (void)arg;
+    return shown != (uint32_t)(now() / 1000000000);
+}
+
+static uint16_t clock_render(void *arg, char *buf, uint16_t size)
+{
+    (void)arg;
+    shown = now() / 1000000000;
+    return snprintf(buf, size, "%02u", shown % 60);
+}
+
+static const vln_pptvar_t vars[] = {
+    { 't', NULL, clock_poll, clock_render },
+};
+
+static char pptbuff[64];
+#endif
+
+static int cmp(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void *writer(void *arg)
+{
+    struct timespec gap = { 0, 10000000 };
+    double idle;
+    int i;
+
+    (void)arg;
+
+    /*!< let the first prompt settle, then watch it idle */
+    sleep(1);
+    atomic_store(&redraws, 0);
+    idle = cpu();
+    sleep(WAIT_IDLE);
+    idle = (cpu() - idle) / WAIT_IDLE;
+
+    printf("idle cpu %.1f ms/s, %d prompt redraws in %d s\n",
+           idle * 1000, atomic_load(&redraws), WAIT_IDLE);
+
+    for (i = 0; i < WAIT_KEYS; i++) {
+        nanosleep(&gap, NULL);
+        sent = now();
+        atomic_store(&want, 1);
+        if (write(fds[1], (i % 60 == 59) ? "\r" : "a", 1) != 1) {
+            break;
+        }
+
+        while (atomic_load(&want)) {
+            sched_yield();
+        }
+    }
+
+    qsort(lat, nlat, sizeof(lat[0]), cmp);
+    printf("echo latency p50 %.1f us p99 %.1f us max %.1f us\n",
+           lat[nlat / 2] / 1e3, lat[nlat * 99 / 100] / 1e3, lat[nlat - 1] / 1e3);
+
+    exit(0);
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(void)
+{
+    vln_init_t init = { 0 };
+    pthread_t thread;
+    uint32_t size;
+
+    if (pipe(fds) || fcntl(fds[0], F_SETFL, O_NONBLOCK)) {
+        return 1;
+    }
+
+    init.prompt = "> ";
+    init.sput = sput;
+    init.sget = sget;
+    init.tick = tick;
+    init.wait = getenv("SPIN") ? NULL : wait_fd;
+    init.history = history;
+    init.histsize = sizeof(history);
+
+    vln_init(&session, &init);
+    vln_term(&session, VLN_TERM_XTERM);
+
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    vln_prompt(&session, "%t > ", vars, 1, pptbuff, sizeof(pptbuff));
+#endif
+
+    pthread_create(&thread, NULL, writer, NULL);
+
+    for (;;) {
+        vln(&session, linebuff, sizeof(linebuff), &size);
+    }
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
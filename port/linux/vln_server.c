@@ -0,0 +1,629 @@
+/*****************************************************************************
+* @file         vln_server.c
+* @brief        epoll console server, serves one vln session per socket with
+*               non-blocking io, one event loop per core
+*
+*   cc -O2 -pthread -I. vln.c port/linux/vln_server.c -o vln_server
+*
+*   ./vln_server -p 2323 -t 4           serve, attach with
+*                                       socat -,raw,echo=0 tcp:host:2323
+*   ./vln_server -t 4 -c 4000 -s 10     load test with 4000 local clients
+*
+* Each worker thread owns a SO_REUSEPORT listen socket and an epoll set,
+* so the kernel spreads connections over the workers and a session never
+* leaves its worker. vln callbacks carry no context, sput and sget work on
+* the session the worker is currently serving. Output is queued without
+* loss, and a session whose client falls behind stops reading input until
+* its queue drains.
+*
+* The load generator opens the clients on the same host and types one key
+* at a time, waiting for its echo before the next one. With the default
+* build a character at end of line echoes 1 byte and enter echoes newline
+* and prompt, so the reply size is known without parsing it.
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.02.25
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include "vln.h"
+
+/* private macro -----------------------------------------------------------*/
+#define SERVER_PROMPT   "vln> "
+#define SERVER_EVENTS   256
+#define SERVER_LINEMAX  40      /*!< characters typed per line by clients */
+#define SERVER_HISTMAX  100000  /*!< latency histogram range in us */
+#define SERVER_TXINIT   2048    /*!< tx queue size at accept */
+#define SERVER_TXHIGH   4096    /*!< stop reading input above this much tx */
+#define SERVER_TXMAX    (1 << 20) /*!< tx queue limit, the client is dropped */
+
+/* private types -----------------------------------------------------------*/
+typedef struct session {
+    vln_t vln;
+    int fd;
+    uint8_t closing;         /*!< close after tx drained */
+    uint8_t broken;          /*!< tx over limit, close now */
+    uint16_t rxoff;          /*!< rx read offset         */
+    uint16_t rxlen;          /*!< rx size                */
+    uint32_t events;         /*!< epoll events armed     */
+    uint32_t txlen;          /*!< tx pending size        */
+    uint32_t txsize;         /*!< tx queue size          */
+    char *tx;                /*!< tx queue               */
+    char rx[512];
+    char linebuff[256] __attribute__((aligned(4)));
+    char histbuff[1024] __attribute__((aligned(4)));
+} session_t;
+
+typedef struct {
+    pthread_t thread;
+    int id;
+    int lfd;
+    int epfd;
+} worker_t;
+
+typedef struct {
+    int fd;
+    uint8_t col;             /*!< characters typed in line */
+    uint16_t expect;         /*!< reply size of last key   */
+    uint16_t got;            /*!< reply bytes received     */
+    uint64_t sent;           /*!< key sent time, 0:no key  */
+} client_t;
+
+typedef struct {
+    pthread_t thread;
+    int id;
+    uint32_t nclient;
+    uint64_t keys;
+    uint32_t hist[SERVER_HISTMAX + 1];
+} driver_t;
+
+/* private variables -------------------------------------------------------*/
+static __thread session_t *current;
+
+static uint16_t port = 2323;
+static int nworker;
+static uint32_t nclient;
+static unsigned seconds = 5;
+static int detect;
+
+static worker_t *workers;
+static driver_t *drivers;
+
+static volatile int running = 1;
+static volatile int measuring;
+static pthread_barrier_t ready;
+
+/* private functions -------------------------------------------------------*/
+
+static uint64_t server_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t server_tick(void)
+{
+    return (uint32_t)(server_now() / 1000000ull);
+}
+
+/*****************************************************************************
+* @brief        write pending output, arm EPOLLOUT if socket is full, and
+*               stop reading input while the client does not take output
+*****************************************************************************/
+static void session_flush(worker_t *w, session_t *s)
+{
+    struct epoll_event ev;
+    ssize_t n;
+    uint32_t off = 0;
+
+    while (off < s->txlen) {
+        n = write(s->fd, s->tx + off, s->txlen - off);
+        if (n <= 0) {
+            break;
+        }
+        off += n;
+    }
+
+    memmove(s->tx, s->tx + off, s->txlen - off);
+    s->txlen -= off;
+
+    ev.events = ((s->txlen < SERVER_TXHIGH) ? EPOLLIN : 0) | (s->txlen ? EPOLLOUT : 0);
+    if (ev.events != s->events) {
+        s->events = ev.events;
+        ev.data.ptr = s;
+        epoll_ctl(w->epfd, EPOLL_CTL_MOD, s->fd, &ev);
+    }
+}
+
+/*****************************************************************************
+* @brief        queue output, the queue grows instead of dropping bytes, a
+*               lost redraw byte would leave the client screen out of step
+*               with the line. input stops above SERVER_TXHIGH, so it only
+*               grows past that by the output of one read
+*****************************************************************************/
+static uint16_t session_sput(void *buf, uint16_t size)
+{
+    session_t *s = current;
+    uint32_t need = s->txlen + size;
+    uint32_t grow = s->txsize;
+    char *tx;
+
+    if (need > s->txsize) {
+        while (grow < need) {
+            grow *= 2;
+        }
+
+        tx = (grow <= SERVER_TXMAX) ? realloc(s->tx, grow) : NULL;
+        if (NULL == tx) {
+            s->broken = 1;
+            return 0;
+        }
+
+        s->tx = tx;
+        s->txsize = grow;
+    }
+
+    memcpy(s->tx + s->txlen, buf, size);
+    s->txlen += size;
+    return size;
+}
+
+static uint16_t session_sget(void *buf, uint16_t size)
+{
+    session_t *s = current;
+
+    if ((size == 0) || s->broken || (s->rxoff >= s->rxlen)) {
+        return 0;
+    }
+
+    *(char *)buf = s->rx[s->rxoff++];
+    return 1;
+}
+
+static void session_close(worker_t *w, session_t *s)
+{
+    epoll_ctl(w->epfd, EPOLL_CTL_DEL, s->fd, NULL);
+    close(s->fd);
+    free(s->tx);
+    free(s);
+}
+
+/*****************************************************************************
+* @brief        run the editor over received bytes, handle finished lines
+*****************************************************************************/
+static void session_input(worker_t *w, session_t *s)
+{
+    uint32_t size;
+    char *line;
+
+    current = s;
+
+    do {
+        line = vln_isr(&s->vln, s->linebuff, sizeof(s->linebuff), &size);
+
+        if ((NULL != line) && (!strcmp(line, "exit") || !strcmp(line, "quit"))) {
+            s->closing = 1;
+            break;
+        }
+    } while (NULL != line);
+
+    current = NULL;
+    session_flush(w, s);
+}
+
+static void session_accept(worker_t *w)
+{
+    vln_init_t init = {
+        .prompt = SERVER_PROMPT,
+        .sput = session_sput,
+        .sget = session_sget,
+        .tick = server_tick,
+    };
+    struct epoll_event ev;
+    session_t *s;
+    int one = 1;
+    int fd;
+
+    while ((fd = accept4(w->lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        s = calloc(1, sizeof(session_t));
+        if ((NULL == s) || (NULL == (s->tx = malloc(SERVER_TXINIT)))) {
+            free(s);
+            close(fd);
+            continue;
+        }
+
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        s->fd = fd;
+        s->txsize = SERVER_TXINIT;
+        s->events = EPOLLIN;
+        init.history = s->histbuff;
+        init.histsize = sizeof(s->histbuff);
+
+        ev.events = EPOLLIN;
+        ev.data.ptr = s;
+        if (vln_init(&s->vln, &init) || epoll_ctl(w->epfd, EPOLL_CTL_ADD, fd, &ev)) {
+            close(fd);
+            free(s->tx);
+            free(s);
+            continue;
+        }
+
+        current = s;
+        if (detect) {
+            vln_detect(&s->vln);
+        }
+        /*!< no input yet, outputs prompt */
+        session_input(w, s);
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    worker_t *w = arg;
+    struct epoll_event events[SERVER_EVENTS];
+    struct epoll_event ev;
+    session_t *s;
+    cpu_set_t cpus;
+    ssize_t n;
+    int nev;
+
+    CPU_ZERO(&cpus);
+    CPU_SET(w->id % sysconf(_SC_NPROCESSORS_ONLN), &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    epoll_ctl(w->epfd, EPOLL_CTL_ADD, w->lfd, &ev);
+
+    for (;;) {
+        nev = epoll_wait(w->epfd, events, SERVER_EVENTS, 100);
+
+        for (int i = 0; i < nev; i++) {
+            s = events[i].data.ptr;
+
+            if (NULL == s) {
+                session_accept(w);
+                continue;
+            }
+
+            if (events[i].events & EPOLLOUT) {
+                session_flush(w, s);
+            }
+
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                /*!< only read again once the editor consumed everything */
+                if (s->rxoff >= s->rxlen) {
+                    n = read(s->fd, s->rx, sizeof(s->rx));
+                    if ((n == 0) || ((n < 0) && (errno != EAGAIN))) {
+                        session_close(w, s);
+                        continue;
+                    }
+                    s->rxoff = 0;
+                    s->rxlen = (n > 0) ? n : 0;
+                }
+                session_input(w, s);
+            }
+
+            if (s->broken || (s->closing && (s->txlen == 0))) {
+                session_close(w, s);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static int listen_socket(uint16_t *lport)
+{
+    struct sockaddr_in addr = { .sin_family = AF_INET };
+    socklen_t len = sizeof(addr);
+    int one = 1;
+    int fd;
+
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+    addr.sin_port = htons(*lport);
+    addr.sin_addr.s_addr = htonl(nclient ? INADDR_LOOPBACK : INADDR_ANY);
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) ||
+        listen(fd, SOMAXCONN) ||
+        getsockname(fd, (struct sockaddr *)&addr, &len)) {
+        close(fd);
+        return -1;
+    }
+
+    *lport = ntohs(addr.sin_port);
+    return fd;
+}
+
+/*****************************************************************************
+* @brief        type the next key, enter after SERVER_LINEMAX characters
+*****************************************************************************/
+static void client_key(client_t *c)
+{
+    char key;
+
+    if (c->col < SERVER_LINEMAX) {
+        key = 'a' + c->col % 26;
+        c->expect = 1;
+        c->col++;
+    } else {
+        key = '\r';
+        c->expect = sizeof(CFG_VLN_NEWLINE) - 1 + sizeof(SERVER_PROMPT) - 1;
+        c->col = 0;
+    }
+
+    c->got = 0;
+    c->sent = server_now();
+    if (write(c->fd, &key, 1) != 1) {
+        c->sent = 0;
+    }
+}
+
+static void *driver_main(void *arg)
+{
+    driver_t *d = arg;
+    struct sockaddr_in addr = { .sin_family = AF_INET };
+    struct epoll_event events[SERVER_EVENTS];
+    struct epoll_event ev;
+    client_t *clients;
+    client_t *c;
+    uint64_t us;
+    char buf[256];
+    ssize_t n;
+    int epfd;
+    int nev;
+
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    clients = calloc(d->nclient, sizeof(client_t));
+
+    for (uint32_t i = 0; i < d->nclient; i++) {
+        c = &clients[i];
+        c->fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if ((c->fd < 0) || connect(c->fd, (struct sockaddr *)&addr, sizeof(addr))) {
+            perror("vln_server: connect");
+            exit(1);
+        }
+
+        n = 1;
+        setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &n, sizeof(int));
+        fcntl(c->fd, F_SETFL, O_NONBLOCK);
+
+        /*!< first reply is the prompt */
+        c->expect = sizeof(SERVER_PROMPT) - 1;
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, c->fd, &ev);
+    }
+
+    pthread_barrier_wait(&ready);
+
+    while (running) {
+        nev = epoll_wait(epfd, events, SERVER_EVENTS, 10);
+
+        for (int i = 0; i < nev; i++) {
+            c = events[i].data.ptr;
+
+            n = read(c->fd, buf, sizeof(buf));
+            if (n <= 0) {
+                continue;
+            }
+
+            c->got += n;
+            if (c->got < c->expect) {
+                continue;
+            }
+
+            if (c->sent && measuring) {
+                us = (server_now() - c->sent) / 1000;
+                d->hist[(us > SERVER_HISTMAX) ? SERVER_HISTMAX : us]++;
+                d->keys++;
+            }
+
+            client_key(c);
+        }
+    }
+
+    return NULL;
+}
+
+static uint64_t worker_cputime(void)
+{
+    struct timespec ts;
+    clockid_t cid;
+    uint64_t sum = 0;
+
+    for (int i = 0; i < nworker; i++) {
+        if (!pthread_getcpuclockid(workers[i].thread, &cid) &&
+            !clock_gettime(cid, &ts)) {
+            sum += (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+        }
+    }
+
+    return sum;
+}
+
+static unsigned percentile(const uint32_t *hist, uint64_t total, double p)
+{
+    uint64_t want = (uint64_t)(total * p);
+    uint64_t sum = 0;
+
+    for (unsigned i = 0; i <= SERVER_HISTMAX; i++) {
+        sum += hist[i];
+        if (sum > want) {
+            return i;
+        }
+    }
+
+    return SERVER_HISTMAX;
+}
+
+static int loadtest(void)
+{
+    static uint32_t hist[SERVER_HISTMAX + 1];
+    uint64_t keys = 0;
+    uint64_t start, cpu;
+    double wall;
+
+    drivers = calloc(nworker, sizeof(driver_t));
+    pthread_barrier_init(&ready, NULL, nworker + 1);
+
+    for (int i = 0; i < nworker; i++) {
+        drivers[i].id = i;
+        drivers[i].nclient = nclient / nworker + ((uint32_t)i < nclient % nworker);
+        pthread_create(&drivers[i].thread, NULL, driver_main, &drivers[i]);
+    }
+
+    pthread_barrier_wait(&ready);
+
+    /*!< kick every client with its first key once prompts arrived */
+    sleep(1);
+    measuring = 1;
+    start = server_now();
+    cpu = worker_cputime();
+
+    sleep(seconds);
+
+    measuring = 0;
+    wall = (server_now() - start) / 1e9;
+    cpu = worker_cputime() - cpu;
+    running = 0;
+
+    for (int i = 0; i < nworker; i++) {
+        pthread_join(drivers[i].thread, NULL);
+        keys += drivers[i].keys;
+        for (unsigned j = 0; j <= SERVER_HISTMAX; j++) {
+            hist[j] += drivers[i].hist[j];
+        }
+    }
+
+    if (keys == 0) {
+        fprintf(stderr, "vln_server: no keystroke echoed\n");
+        return 1;
+    }
+
+    printf("sessions %u workers %d sessions/core %.0f\n",
+           nclient, nworker, (double)nclient / nworker);
+    printf("keys %llu keys/s %.0f keys/cpu-s %.0f server cpu %.1f%%\n",
+           (unsigned long long)keys, keys / wall, keys / (cpu / 1e9),
+           100.0 * (cpu / 1e9) / wall / nworker);
+    printf("echo p50 %uus p99 %uus\n",
+           percentile(hist, keys, 0.50), percentile(hist, keys, 0.99));
+
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: vln_server [-p port] [-t workers] [-d]\n"
+            "       vln_server [-t workers] -c clients [-s seconds]\n");
+    exit(2);
+}
+
+/* exported functions ------------------------------------------------------*/
+
+int main(int argc, char **argv)
+{
+    struct rlimit rl;
+    int opt;
+
+    nworker = sysconf(_SC_NPROCESSORS_ONLN);
+
+    while ((opt = getopt(argc, argv, "p:t:c:s:d")) != -1) {
+        switch (opt) {
+            case 'p':
+                port = (uint16_t)atoi(optarg);
+                break;
+            case 't':
+                nworker = atoi(optarg);
+                break;
+            case 'c':
+                nclient = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seconds = (unsigned)atoi(optarg);
+                break;
+            case 'd':
+                detect = 1;
+                break;
+            default:
+                usage();
+        }
+    }
+
+    if (nworker <= 0) {
+        usage();
+    }
+
+    /*!< two descriptors per client in load test */
+    if (!getrlimit(RLIMIT_NOFILE, &rl)) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    if (nclient) {
+        port = 0;
+    }
+
+    workers = calloc(nworker, sizeof(worker_t));
+
+    for (int i = 0; i < nworker; i++) {
+        workers[i].id = i;
+        workers[i].lfd = listen_socket(&port);
+        workers[i].epfd = epoll_create1(EPOLL_CLOEXEC);
+        if ((workers[i].lfd < 0) || (workers[i].epfd < 0)) {
+            perror("vln_server: listen");
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < nworker; i++) {
+        pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]);
+    }
+
+    if (nclient) {
+        return loadtest();
+    }
+
+    fprintf(stderr, "vln_server: %d workers on port %u\n", nworker, port);
+    pthread_join(workers[0].thread, NULL);
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
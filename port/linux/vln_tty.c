@@ -0,0 +1,322 @@
+/*****************************************************************************
+* @file         vln_tty.c
+* @brief        linux terminal backend for vln
+*
+*   cc -O2 -I. -Iport/linux vln.c port/linux/vln_tty.c app.c -o app
+*
+*   vln_init_t init = { .prompt = "> ", .history = hist, .histsize = 1024 };
+*   vln_tty_open(&session, &init, STDIN_FILENO, STDOUT_FILENO);
+*   while (NULL != (line = vln_tty_line(&session, buf, sizeof(buf), &size))) {
+*       ...
+*   }
+*
+* Input is put in raw mode: no echo, no line discipline editing and no
+* signals from keys, so Ctrl-C reaches vln. Output processing stays on, so
+* the application can printf between two lines as usual. sget never
+* blocks, it polls the input for what is ready. The wait callback sleeps
+* in poll until input arrives, the vln timeout passes or a signal comes.
+*
+* SIGWINCH only sets a flag. The next sget reads the new size and calls
+* vln_resize, so the line is redrawn from the editor's own thread. The
+* terminal is restored by vln_tty_close, at exit, and on SIGTERM, SIGHUP,
+* SIGINT or SIGQUIT when those are left at their default. SIGCONT puts
+* the terminal back in raw mode and redraws the line, a shell may have
+* reset it while the process was stopped.
+*
+* Once input is closed or hung up, sget feeds Ctrl-C so the line in
+* progress ends, and vln_tty_line returns NULL.
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.03.05
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "vln_tty.h"
+
+/* private macro -----------------------------------------------------------*/
+#define TTY_SIGNALS 4 /*!< fatal signals restored on */
+
+/* private types -----------------------------------------------------------*/
+typedef struct {
+    vln_t *vln;                /*!< session, NULL while closed   */
+    int in;                    /*!< input fd                     */
+    int out;                   /*!< output fd                    */
+    uint8_t raw;               /*!< input was put in raw mode    */
+    uint8_t exit;              /*!< atexit handler registered    */
+    volatile sig_atomic_t winch; /*!< window size changed        */
+    volatile sig_atomic_t eof; /*!< input closed or hung up      */
+    struct termios saved;      /*!< mode to restore              */
+    struct termios mode;       /*!< raw mode                     */
+    struct sigaction old[TTY_SIGNALS + 2];
+} tty_t;
+
+/* private variables -------------------------------------------------------*/
+static tty_t tty;
+
+static const int signals[TTY_SIGNALS + 2] = {
+    SIGTERM, SIGHUP, SIGINT, SIGQUIT, SIGWINCH, SIGCONT,
+};
+
+/* private functions -------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        read the window size into vln
+*****************************************************************************/
+static void tty_winsize(void)
+{
+    struct winsize ws;
+
+    if (((0 == ioctl(tty.out, TIOCGWINSZ, &ws)) || (0 == ioctl(tty.in, TIOCGWINSZ, &ws))) &&
+        ws.ws_row && ws.ws_col) {
+        vln_resize(tty.vln, ws.ws_row, ws.ws_col);
+    }
+}
+
+static void tty_signal(int sig)
+{
+    int i;
+
+    if (SIGWINCH == sig) {
+        tty.winch = 1;
+        return;
+    }
+
+    if (SIGCONT == sig) {
+        if (tty.raw) {
+            tcsetattr(tty.in, TCSADRAIN, &tty.mode);
+        }
+        tty.winch = 1;
+        return;
+    }
+
+    /*!< only installed over default actions, so die the default way */
+    if (tty.raw) {
+        tcsetattr(tty.in, TCSADRAIN, &tty.saved);
+    }
+
+    for (i = 0; i < TTY_SIGNALS; i++) {
+        if (signals[i] == sig) {
+            sigaction(sig, &tty.old[i], NULL);
+        }
+    }
+
+    raise(sig);
+}
+
+static uint16_t tty_sput(void *buf, uint16_t size)
+{
+    struct pollfd p = { .fd = tty.out, .events = POLLOUT };
+    uint16_t off = 0;
+    ssize_t n;
+
+    while (off < size) {
+        n = write(tty.out, (char *)buf + off, size - off);
+        if (n > 0) {
+            off += n;
+        } else if ((n < 0) && (errno == EAGAIN)) {
+            poll(&p, 1, -1);
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            break;
+        }
+    }
+
+    return off;
+}
+
+static uint16_t tty_sget(void *buf, uint16_t size)
+{
+    struct pollfd p = { .fd = tty.in, .events = POLLIN };
+    ssize_t n;
+
+    if (tty.winch) {
+        tty.winch = 0;
+        tty_winsize();
+    }
+
+    if (!tty.eof && (1 == poll(&p, 1, 0))) {
+        if (p.revents & POLLIN) {
+            n = read(tty.in, buf, size);
+            if (n > 0) {
+                return (uint16_t)n;
+            }
+            if ((0 == n) || ((errno != EAGAIN) && (errno != EINTR))) {
+                tty.eof = 1;
+            }
+        } else {
+            tty.eof = 1;
+        }
+    }
+
+    /*!< end the line in progress, vln_tty_line sees eof */
+    if (tty.eof) {
+        *(char *)buf = VLN_C0_ETX;
+        return 1;
+    }
+
+    return 0;
+}
+
+static uint32_t tty_tick(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000u + ts.tv_nsec / 1000000u);
+}
+
+static void tty_wait(uint32_t ms)
+{
+    struct pollfd p = { .fd = tty.in, .events = POLLIN };
+
+    /*!< a signal ends the wait early, sget then handles it */
+    poll(&p, 1, (ms == VLN_WAIT_FOREVER) ? -1 : (int)ms);
+}
+
+/* exported functions ------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        open terminal, input goes to raw mode if it is a tty, init
+*               gets the backend callbacks and vln is initialised with it
+*               and sized to the window
+*
+* @param[in]    vln
+* @param[inout] init        init param, prompt and buffers set by caller
+* @param[in]    in          input fd
+* @param[in]    out         output fd
+*
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+int vln_tty_open(vln_t *vln, vln_init_t *init, int in, int out)
+{
+    struct sigaction sa;
+    const char *term;
+    int i;
+
+    if ((NULL == vln) || (NULL == init) || (NULL != tty.vln)) {
+        return -1;
+    }
+
+    tty.vln = vln;
+    tty.in = in;
+    tty.out = out;
+    tty.raw = 0;
+    tty.winch = 0;
+    tty.eof = 0;
+
+    init->sput = tty_sput;
+    init->sget = tty_sget;
+    init->tick = tty_tick;
+    init->wait = tty_wait;
+
+    if (vln_init(vln, init)) {
+        tty.vln = NULL;
+        return -1;
+    }
+
+    term = getenv("TERM");
+    if ((NULL != term) && !strcmp(term, "dumb")) {
+        vln_term(vln, VLN_TERM_DUMB);
+    }
+
+    if (isatty(in) && (0 == tcgetattr(in, &tty.saved))) {
+        tty.mode = tty.saved;
+        tty.mode.c_iflag &= ~(BRKINT | ICRNL | INLCR | IGNCR | INPCK | ISTRIP | IXON);
+        tty.mode.c_cflag |= CS8;
+        tty.mode.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+        tty.mode.c_cc[VMIN] = 1;
+        tty.mode.c_cc[VTIME] = 0;
+
+        /*!< keys typed ahead are kept */
+        if (0 == tcsetattr(in, TCSADRAIN, &tty.mode)) {
+            tty.raw = 1;
+        }
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = tty_signal;
+    sigemptyset(&sa.sa_mask);
+
+    for (i = 0; i < TTY_SIGNALS + 2; i++) {
+        sigaction(signals[i], NULL, &tty.old[i]);
+        if ((i >= TTY_SIGNALS) || (SIG_DFL == tty.old[i].sa_handler)) {
+            sigaction(signals[i], &sa, NULL);
+        }
+    }
+
+    if (!tty.exit) {
+        atexit(vln_tty_close);
+        tty.exit = 1;
+    }
+
+    tty_winsize();
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        readline on the terminal
+*
+* @param[in]    session     vln opened on the terminal
+* @param[in]    linebuff    linebuff pointer
+* @param[in]    buffsize    linebuff size
+* @param[out]   linesize    readline size
+*
+* @retval char*             line pointer, NULL once input is closed or on
+*                           output error
+*****************************************************************************/
+char *vln_tty_line(vln_t *session, char *linebuff, uint32_t buffsize, uint32_t *linesize)
+{
+    char *line;
+
+    if (tty.eof) {
+        return NULL;
+    }
+
+    line = vln(session, linebuff, buffsize, linesize);
+
+    return tty.eof ? NULL : line;
+}
+
+/*****************************************************************************
+* @brief        restore terminal mode and signal actions
+*****************************************************************************/
+void vln_tty_close(void)
+{
+    int i;
+
+    if (NULL == tty.vln) {
+        return;
+    }
+
+    for (i = 0; i < TTY_SIGNALS + 2; i++) {
+        sigaction(signals[i], &tty.old[i], NULL);
+    }
+
+    if (tty.raw) {
+        tcsetattr(tty.in, TCSADRAIN, &tty.saved);
+        tty.raw = 0;
+    }
+
+    tty.vln = NULL;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
@@ -0,0 +1,58 @@
+/*****************************************************************************
+* @file         vln_tty.h
+* @brief        linux terminal backend, runs vln on a tty in raw mode with
+*               poll based waiting, window size updates and the terminal
+*               restored on exit
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.03.05
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+* @htmlonly
+* <span style='font-weight: bold'>History</span>
+* @endhtmlonly
+* Version|Author|Date|Biref
+* ----|----|----|----
+* 1.0|Egahp|2023.03.05|Create
+*****************************************************************************/
+
+#ifndef __vln_tty_h__
+#define __vln_tty_h__
+
+/* includes ----------------------------------------------------------------*/
+#include "vln.h"
+
+/** @addtogroup vln_tty
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/** @defgroup   vln_tty_functions functions
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*!< one terminal per process, sput, sget, tick and wait of init are set */
+extern int vln_tty_open(vln_t *vln, vln_init_t *init, int in, int out);
+
+/*!< vln on the terminal, NULL once input is closed or hung up */
+extern char *vln_tty_line(vln_t *session, char *linebuff, uint32_t buffsize, uint32_t *linesize);
+
+/*!< restore the terminal, also run at exit and on fatal signals */
+extern void vln_tty_close(void);
+/*---------------------------------------------------------------------------
+* @}            vln_tty_functions functions
+----------------------------------------------------------------------------*/
+
+/**
+* @}
+*/
+
+#endif
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
@@ -26,19 +26,104 @@
 #include <string.h>
 #include "vln.h"
 
+#if defined(CFG_VLN_SHARE) && CFG_VLN_SHARE
+#include "vln_share.h"
+#endif
+
 // #pragma GCC push_options
 // #pragma GCC optimize("Os")
 // #pragma GCC optimize("-fjump-tables")
 
 /* private types -----------------------------------------------------------*/
+enum {
+    VLN_SEQ_NONE = 0, /*!< not in sequence */
+    VLN_SEQ_ESC,      /*!< got esc         */
+    VLN_SEQ_CSI,      /*!< got esc [       */
+    VLN_SEQ_SS3,      /*!< got esc O       */
+    VLN_SEQ_APC,      /*!< got esc _       */
+    VLN_SEQ_FRAME,    /*!< got esc _ V     */
+};
+
+/*!< output profile, a move cost is counted in bytes and 0 means the
+     terminal can not do it */
+typedef struct {
+    uint8_t cha; /*!< CHA bytes besides digits    */
+    uint8_t rel; /*!< CUB/CUF bytes besides digits */
+    uint8_t bs;  /*!< BS bytes per column          */
+    uint8_t cr;  /*!< CR bytes before prompt       */
+    uint8_t esc; /*!< ED, SGR and ignores unknown  */
+    uint8_t ech; /*!< ECH                          */
+    uint8_t ext; /*!< xterm colours                */
+    uint8_t colors; /*!< VLN_COLORS_*, 0 for no sgr */
+} vln_profile_t;
+
+/*!< undo record, followed by removed text, inserted text and the record
+     size so the journal can be walked both ways */
+typedef struct {
+    uint16_t off; /*!< edit offset    */
+    uint16_t del; /*!< removed bytes  */
+    uint16_t ins; /*!< inserted bytes */
+} vln_undo_rec_t;
+
+/*!< open probe span */
+typedef struct {
+    uint32_t start; /*!< cycles at begin             */
+    uint32_t outer; /*!< nested cycles of the parent */
+} vln_span_probe_t;
+
 /* private macro -----------------------------------------------------------*/
+#ifndef __unused
+#define __unused __attribute__((unused))
+#endif
+
+#define VLN_OFF_NONE UINT16_MAX /*!< no offset or unknown column */
+
+#define VLN_SWAR_ONES ((uintptr_t)-1 / 0xff)  /*!< 0x01 in every byte */
+#define VLN_SWAR_HIGH (VLN_SWAR_ONES * 0x80) /*!< 0x80 in every byte */
 
-#define vln_waitkey(__line, __c)              \
-    do {                                      \
-        while (0 == (__line)->sget((__c), 1)) \
-            ;                                 \
+/*!< nonzero if any byte of word is zero */
+#define VLN_SWAR_ZERO(__w) (((__w) - VLN_SWAR_ONES) & ~(__w) & VLN_SWAR_HIGH)
+#define VLN_COST_NONE UINT16_MAX /*!< move not possible */
+
+#define VLN_UNDO_OVERHEAD (sizeof(vln_undo_rec_t) + 2) /*!< header and size */
+
+/*!< frame intro and header, kept in front of the payload so a response is
+     built in place, the crc and ESC \ follow the payload */
+#define VLN_FRAME_INTRO 3 /*!< ESC _ V            */
+#define VLN_FRAME_HEAD 4  /*!< type, tag, length  */
+#define VLN_FRAME_TAIL 4  /*!< crc, ESC \         */
+
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+#define VLN_UNDO_RECORD(__line, __off, __del, __ins, __n) \
+    vln_undo_record((__line), (__off), (__del), (__ins), (__n))
+#else
+#define VLN_UNDO_RECORD(__line, __off, __del, __ins, __n)
+#endif
+
+#define vln_waitkey(__line, __c)               \
+    do {                                       \
+        while (0 == vln_getc((__line), (__c))) \
+            vln_idle(__line);                  \
     } while (0)
 
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+
+#define VLN_PROBE_BEGIN(__line, __span) \
+    vln_span_probe_t __span;            \
+    vln_probe_begin((__line), &__span)
+
+#define VLN_PROBE_END(__line, __span, __stage) vln_probe_end((__line), &__span, (__stage))
+
+#define VLN_SPUT(__line, __pbuf, __size) vln_probe_sput((__line), (__pbuf), (__size))
+
+#else
+
+#define VLN_PROBE_BEGIN(__line, __span)
+#define VLN_PROBE_END(__line, __span, __stage)
+#define VLN_SPUT(__line, __pbuf, __size) (__line)->sput((__pbuf), (__size))
+
+#endif
+
 #if defined(CFG_VLN_DEBUG) && CFG_VLN_DEBUG
 
 #define VLN_PARAM_CHECK(__expr, __ret) \
@@ -51,7 +136,7 @@
 #define vln_put(__line, __pbuf, __size, __ret)            \
     do {                                                  \
         uint16_t _size_ = (__size);                       \
-        if (_size_ != (__line)->sput((__pbuf), _size_)) { \
+        if (_size_ != VLN_SPUT(__line, __pbuf, _size_)) { \
             return (__ret);                               \
         }                                                 \
     } while (0)
@@ -60,9 +145,9 @@
 
 #define VLN_PARAM_CHECK(__expr, __ret) ((void)0)
 
-#define vln_put(__line, __pbuf, __size, __ret) \
-    do {                                       \
-        (__line)->sput((__pbuf), (__size));    \
+#define vln_put(__line, __pbuf, __size, __ret)   \
+    do {                                         \
+        VLN_SPUT(__line, (__pbuf), (__size));    \
     } while (0)
 
 #endif
@@ -105,8 +190,8 @@ static const uint8_t vtmap[25] = {
     VLN_EXEC_NUL,  /*!< 2  insert   */
     VLN_EXEC_DEL,  /*!< 3  delete   */
     VLN_EXEC_MVED, /*!< 4  end      */
-    VLN_EXEC_NUL,  /*!< 5  page up  */
-    VLN_EXEC_NUL,  /*!< 6  page dn  */
+    VLN_EXEC_PGUP, /*!< 5  page up  */
+    VLN_EXEC_PGDN, /*!< 6  page dn  */
     VLN_EXEC_MVHM, /*!< 7  home     */
     VLN_EXEC_MVED, /*!< 8  end      */
     VLN_EXEC_NUL,  /*!< 9           */
@@ -160,7 +245,7 @@ static const uint8_t c0map[32] = {
     VLN_EXEC_MVRT, /*!< F ACK */
     VLN_EXEC_ALN,  /*!< G BEL */
     VLN_EXEC_BS,   /*!< H BS  */
-    VLN_EXEC_NUL,  /*!< I HT  */
+    VLN_EXEC_ACPT, /*!< I HT  */
     VLN_EXEC_NLN,  /*!< J LF  */
     VLN_EXEC_DELN, /*!< K VT  */
     VLN_EXEC_CLR,  /*!< L FF  */
@@ -176,15 +261,45 @@ static const uint8_t c0map[32] = {
     VLN_EXEC_NUL,  /*!< V SYN */
     VLN_EXEC_DLWD, /*!< W ETB */
     VLN_EXEC_NUL,  /*!< X CAN */
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+    VLN_EXEC_REDO, /*!< Y EM  */
+    VLN_EXEC_UNDO, /*!< Z SUB */
+#else
     VLN_EXEC_NUL,  /*!< Y EM  */
     VLN_EXEC_ALN,  /*!< Z SUB */
+#endif
     VLN_EXEC_NUL,  /*!< [ ESC */
     VLN_EXEC_NUL,  /*!< \ FS  */
     VLN_EXEC_NUL,  /*!< ] GS  */
     VLN_EXEC_SWNM, /*!< ^ RS  */
     VLN_EXEC_HELP, /*!< - US  */
 };
+static const char spaces[8] = "        ";
+
+static const vln_profile_t profiles[4] = {
+    [VLN_TERM_DUMB]  = { .cha = 0, .rel = 0, .bs = 1, .cr = 1, .esc = 0, .ech = 0, .ext = 0, .colors = 0 },
+    [VLN_TERM_VT100] = { .cha = 0, .rel = 3, .bs = 1, .cr = 1, .esc = 1, .ech = 0, .ext = 0, .colors = VLN_COLORS_8 },
+    [VLN_TERM_XTERM] = { .cha = 3, .rel = 3, .bs = 1, .cr = 1, .esc = 1, .ech = 1, .ext = 1, .colors = VLN_COLORS_256 },
+};
+
 /* private functions prototype ---------------------------------------------*/
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+static uint8_t vln_suggest_update(vln_t *vln, uint16_t dirty, uint16_t vis, uint16_t *show);
+static int vln_suggest_draw(vln_t *vln, uint16_t vis, uint16_t show);
+static void vln_suggest_evict(vln_t *vln);
+static void vln_suggest_add(vln_t *vln);
+#endif
+static int vln_edit_sgr(vln_t *vln, uint64_t sgrraw);
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+static void vln_undo_record(vln_t *vln, uint16_t off, uint16_t del, const char *ins, uint16_t n);
+#endif
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+static int vln_stream_insert(vln_t *vln, char c);
+#endif
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+static uint16_t vln_probe_sput(vln_t *vln, void *buf, uint16_t size);
+#endif
+static int vln_edit_output(vln_t *vln, uint16_t from, uint16_t to);
 /* exported variables ------------------------------------------------------*/
 /* exported constants ------------------------------------------------------*/
 /* private functions -------------------------------------------------------*/
@@ -218,22 +333,78 @@ vln_print_integer(uint8_t *buf, size_t *idx, uint16_t value)
 }
 
 /*****************************************************************************
-* @brief        parse decimal integer (0 - 65535)
-* 
-* @param[in]    buf         parse buf
-* @param[out]   value       16bit unsigned integer pointer
-* 
+* @brief        count of decimal digits printed for value
+*****************************************************************************/
+static uint8_t vln_print_width(uint16_t value)
+{
+    return (value < 10) ? 1 : (value < 100) ? 2 : (value < 1000) ? 3 : (value < 10000) ? 4 : 5;
+}
+
+/*****************************************************************************
+* @brief        output profile of terminal, picked by detection or set by
+*               vln_term, CFG_VLN_TERM is used until then
+*****************************************************************************/
+static const vln_profile_t *vln_profile_get(vln_t *vln)
+{
+    uint8_t type = vln->term.type;
+
+    if ((type == VLN_TERM_UNKNOWN) || (type > VLN_TERM_XTERM)) {
+        type = CFG_VLN_TERM;
+    }
+
+    return &profiles[type];
+}
+
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+/*****************************************************************************
+* @brief        open a probe span, nested spans are subtracted at its end
+*****************************************************************************/
+static void vln_probe_begin(vln_t *vln, vln_span_probe_t *span)
+{
+    span->outer = vln->probe.child;
+    vln->probe.child = 0;
+    span->start = (NULL != vln->probe.cycles) ? vln->probe.cycles() : 0;
+}
+
+/*****************************************************************************
+* @brief        close a probe span, count its own cycles in the log2 bucket
+*               of the stage and hand the whole span to the parent
 *****************************************************************************/
-static void vln_parse_integer(uint8_t *buf, uint16_t *value)
+static void vln_probe_end(vln_t *vln, vln_span_probe_t *span, uint8_t stage)
 {
-    *value = 0;
+    uint32_t total;
+    uint32_t self;
+    uint8_t bucket;
+
+    if (NULL == vln->probe.cycles) {
+        vln->probe.child = span->outer;
+        return;
+    }
+
+    total = vln->probe.cycles() - span->start;
+    self = total - vln->probe.child;
+    bucket = self ? 31 - __builtin_clz(self) : 0;
 
-    while (('0' <= *buf) && (*buf <= '9')) {
-        *value *= 10;
-        *value += *buf - '0';
-        buf++;
+    if (bucket >= CFG_VLN_PROBE_BUCKETS) {
+        bucket = CFG_VLN_PROBE_BUCKETS - 1;
     }
+
+    vln->probe.hist[stage][bucket]++;
+    vln->probe.child = span->outer + total;
+}
+
+/*****************************************************************************
+* @brief        sput inside an output probe span
+*****************************************************************************/
+static uint16_t vln_probe_sput(vln_t *vln, void *buf, uint16_t size)
+{
+    VLN_PROBE_BEGIN(vln, output);
+    size = vln->sput(buf, size);
+    VLN_PROBE_END(vln, output, VLN_PROBE_OUTPUT);
+
+    return size;
 }
+#endif
 
 /** @addtogroup vln_seq_generation
 -----------------------------------------------------------------------------
@@ -287,7 +458,7 @@ __unused static void vln_seqgen_csi2(uint8_t *buf, size_t *idx, char c, uint16_t
     vln_seqgen_csi(buf, idx);
     vln_print_integer(buf, idx, pn);
     buf[(*idx)++] = ';';
-    vln_print_integer(buf, idx, pn);
+    vln_print_integer(buf, idx, pn2);
     buf[(*idx)++] = c;
 }
 
@@ -299,9 +470,9 @@ __unused static void vln_seqgen_csi3(uint8_t *buf, size_t *idx, char c, uint16_t
     vln_seqgen_csi(buf, idx);
     vln_print_integer(buf, idx, pn);
     buf[(*idx)++] = ';';
-    vln_print_integer(buf, idx, pn);
+    vln_print_integer(buf, idx, pn2);
     buf[(*idx)++] = ';';
-    vln_print_integer(buf, idx, pn);
+    vln_print_integer(buf, idx, pn3);
     buf[(*idx)++] = c;
 }
 
@@ -499,1073 +670,5814 @@ __unused static void vln_seqgen_report_screen_size(uint8_t *buf, size_t *idx)
 * @}            vln_seq_generation
 ----------------------------------------------------------------------------*/
 
-/** @addtogroup vln_edit
+/** @addtogroup vln_sgr
 -----------------------------------------------------------------------------
 * @{
 ----------------------------------------------------------------------------*/
+
 /*****************************************************************************
-* @brief        refresh line
-* @retval int               0:Success -1:Error
+* @brief        nearest 256 colour palette entry of a 24 bit colour, from the
+*               6x6x6 cube or the grey ramp
 *****************************************************************************/
-static int vln_edit_refresh(vln_t *vln)
+static uint8_t vln_sgr_index(uint32_t rgb)
 {
-    size_t idx;
-    uint8_t seq[16];
-
-    uint16_t curoff;
-    uint16_t pptoff;
-    uint16_t diff;
-
-    char *linebuff;
-    uint16_t linesize;
-
-    linebuff = vln->ln.buff->pbuf;
-
-    if (vln->ln.buff == NULL) {
-        linesize = 0;
-        curoff = 0;
-        pptoff = 0;
-    } else {
-        linesize = vln->ln.buff->size;
-        curoff = vln->ln.curoff;
-        pptoff = vln->ln.pptoff;
-    }
-
-    if ((pptoff + curoff) >= vln->term.col) {
-        diff = pptoff + curoff - vln->term.col + 1;
-        linebuff += diff;
-        linesize -= diff;
-        curoff -= diff;
-    }
-
-    if ((pptoff + linesize) > vln->term.col) {
-        linesize -= (pptoff + linesize) - vln->term.col;
-    }
-
-    /*!< move to prompt end */
-    idx = 0;
-    vln_seqgen_cursor_absolute(seq, &idx, pptoff + 1);
-    vln_put(vln, seq, idx, -1);
-
-    if (!vln->ln.buff->mask) {
-        /*!< output linbuff */
-        vln_put(vln, linebuff, linesize, -1);
+    static const uint8_t level[6] = { 0, 95, 135, 175, 215, 255 };
+    int16_t c[3] = { (rgb >> 16) & 0xff, (rgb >> 8) & 0xff, rgb & 0xff };
+    int16_t grey = (c[0] + c[1] + c[2]) / 3;
+    uint32_t dcube = 0, dgrey = 0;
+    uint8_t q[3], i;
+
+    grey = (grey < 8) ? 0 : (grey > 238) ? 23 : (grey - 3) / 10;
+
+    for (i = 0; i < 3; i++) {
+        q[i] = (c[i] < 48) ? 0 : (c[i] < 115) ? 1 : (c[i] - 35) / 40;
+        dcube += (c[i] - level[q[i]]) * (c[i] - level[q[i]]);
+        dgrey += (c[i] - 8 - grey * 10) * (c[i] - 8 - grey * 10);
     }
 
-    /*!< erase to end of display and restor cursor */
-    idx = 0;
-    vln_seqgen_erase_display(seq, &idx, 0);
-    vln_seqgen_cursor_absolute(seq, &idx, pptoff + curoff + 1);
-    vln_put(vln, seq, idx, -1);
-
-    return 0;
+    return (dgrey < dcube) ? 232 + grey : 16 + q[0] * 36 + q[1] * 6 + q[2];
 }
 
 /*****************************************************************************
-* @brief        clear screen and refresh line
-* @retval int               0:Success -1:Error
+* @brief        basic colour 0 - 7 nearest a 256 colour palette entry
 *****************************************************************************/
-static int vln_edit_clear(vln_t *vln)
+static uint8_t vln_sgr_basic(uint8_t n)
 {
-    vln_put(vln, "\e[2J\e[1;1H", 10, -1);
+    if (n < 16) {
+        /*!< bright black is closer to white */
+        return (n == 8) ? 7 : (n & 7);
+    }
 
-    /*!< output prompt */
-    vln_put(vln, vln->prompt, vln->ln.pptlen, -1);
+    if (n >= 232) {
+        return (n < 244) ? 0 : 7;
+    }
 
-    return vln_edit_refresh(vln);
+    n -= 16;
+    return ((n / 36) >= 3) | (((n / 6 % 6) >= 3) << 1) | (((n % 6) >= 3) << 2);
 }
 
 /*****************************************************************************
-* @brief        insert a character
-* @retval int               0:Success -1:Error        
+* @brief        colour as the terminal can show it, 0 for default and the
+*               basic VLN_SGR_* for the first 8 entries, so colours that look
+*               the same compare equal
 *****************************************************************************/
-static int vln_edit_insert(vln_t *vln, char c)
+static uint32_t vln_sgr_fit(uint32_t c, uint8_t colors)
 {
-    if (vln->ln.buff->size < vln->ln.lnmax) {
-        if (vln->ln.buff->size != vln->ln.curoff) {
-            memmove(vln->ln.buff->pbuf + vln->ln.curoff + 1,
-                    vln->ln.buff->pbuf + vln->ln.curoff,
-                    vln->ln.buff->size - vln->ln.curoff);
-        }
-
-        vln->ln.buff->pbuf[vln->ln.curoff++] = c;
-        vln->ln.buff->size++;
-
-        if (vln->ln.buff->size != vln->ln.curoff) {
-            return vln_edit_refresh(vln);
+    if (c & VLN_SGR_RGB(0, 0, 0)) {
+        if (colors >= VLN_COLORS_TRUE) {
+            return c;
         }
+        c = VLN_SGR_INDEX(vln_sgr_index(c));
+    }
 
-        if (vln->ln.buff->mask) {
-            c = ' ';
+    if (c & VLN_SGR_INDEX(0)) {
+        c &= 0xff;
+        if (c < 8) {
+            return c + VLN_SGR_BLACK;
         }
-        vln_put(vln, &c, 1, -1);
-
-        return 0;
+        return (colors >= VLN_COLORS_256) ? VLN_SGR_INDEX(c) : (uint32_t)vln_sgr_basic(c) + VLN_SGR_BLACK;
     }
-    return 0;
-}
 
-/*****************************************************************************
-* @brief        delete cursor left character
-* @retval int               0:Success -1:Error    
-*****************************************************************************/
-static int vln_edit_backspace(vln_t *vln)
-{
-    if ((vln->ln.curoff > 0) && (vln->ln.buff->size > 0)) {
-        memmove(vln->ln.buff->pbuf + vln->ln.curoff - 1,
-                vln->ln.buff->pbuf + vln->ln.curoff,
-                vln->ln.buff->size - vln->ln.curoff);
-        vln->ln.buff->size--;
-        vln->ln.curoff--;
-        return vln_edit_refresh(vln);
-    }
-    return 0;
+    return ((c >= VLN_SGR_BLACK) && (c <= VLN_SGR_WHITE)) ? c : VLN_SGR_NONE;
 }
 
 /*****************************************************************************
-* @brief        delete cursor right character
-* @retval int               0:Success -1:Error    
+* @brief        output one param, or only count its bytes if buf is NULL
 *****************************************************************************/
-static int vln_edit_delete(vln_t *vln)
+static void vln_sgr_pn(uint8_t *buf, size_t *idx, uint16_t pn)
 {
-    if ((vln->ln.curoff < vln->ln.buff->size) && (vln->ln.buff->size > 0)) {
-        memmove(vln->ln.buff->pbuf + vln->ln.curoff,
-                vln->ln.buff->pbuf + vln->ln.curoff + 1,
-                vln->ln.buff->size - vln->ln.curoff - 1);
-        vln->ln.buff->size--;
-        return vln_edit_refresh(vln);
+    if (NULL == buf) {
+        *idx += vln_print_width(pn) + 1;
+        return;
     }
 
-    return 0;
+    vln_print_integer(buf, idx, pn);
+    buf[(*idx)++] = ';';
 }
 
 /*****************************************************************************
-* @brief        move cursor to left
-* @retval int               0:Success -1:Error    
+* @brief        output colour params
+* 
+* @param[in]    buf         buffer, NULL to count bytes
+* @param[in]    idx         buffer index
+* @param[in]    base        30 for foreground, 40 for background
+* @param[in]    c           colour
 *****************************************************************************/
-static int vln_edit_moveleft(vln_t *vln)
+static void vln_sgr_color(uint8_t *buf, size_t *idx, uint8_t base, uint32_t c)
 {
-    if (vln->ln.curoff > 0) {
-        vln->ln.curoff--;
-        return vln_edit_refresh(vln);
+    if (c & VLN_SGR_RGB(0, 0, 0)) {
+        vln_sgr_pn(buf, idx, base + 8);
+        vln_sgr_pn(buf, idx, 2);
+        vln_sgr_pn(buf, idx, (c >> 16) & 0xff);
+        vln_sgr_pn(buf, idx, (c >> 8) & 0xff);
+        vln_sgr_pn(buf, idx, c & 0xff);
+    } else if (c & VLN_SGR_INDEX(0)) {
+        c &= 0xff;
+        if (c < 16) {
+            /*!< aixterm bright colours are shorter */
+            vln_sgr_pn(buf, idx, (c < 8) ? base + c : base + 60 + c - 8);
+        } else {
+            vln_sgr_pn(buf, idx, base + 8);
+            vln_sgr_pn(buf, idx, 5);
+            vln_sgr_pn(buf, idx, c);
+        }
+    } else {
+        vln_sgr_pn(buf, idx, base + (((c >= VLN_SGR_BLACK) && (c <= VLN_SGR_WHITE)) ? (uint8_t)(c - 1) : 9));
     }
-
-    return 0;
 }
 
 /*****************************************************************************
-* @brief        move cursor to right
-* @retval int               0:Success -1:Error    
+* @brief        attribute flags in the order of their on params
 *****************************************************************************/
-static int vln_edit_moveright(vln_t *vln)
+static uint8_t vln_sgr_flags(vln_sgr_t sgr)
 {
-    if (vln->ln.curoff < vln->ln.buff->size) {
-        vln->ln.curoff++;
-        return vln_edit_refresh(vln);
-    }
-
-    return 0;
+    return sgr.bold | (sgr.dim << 1) | (sgr.italic << 2) | (sgr.underline << 3) |
+           (sgr.blink << 4) | (sgr.inverse << 5);
 }
 
 /*****************************************************************************
-* @brief        move cursor to start of line
-* @retval int               0:Success -1:Error    
+* @brief        output params that change attributes from to to, each ended
+*               by ';'
+* 
+* @param[in]    buf         buffer, NULL to count bytes
+* @param[in]    idx         buffer index
+* @param[in]    from        attributes on screen
+* @param[in]    to          attributes to set
 *****************************************************************************/
-static int vln_edit_movehome(vln_t *vln)
+static void vln_sgr_params(uint8_t *buf, size_t *idx, vln_sgr_t from, vln_sgr_t to)
 {
-    vln->ln.curoff = 0;
-    return vln_edit_refresh(vln);
-}
+    /*!< bold, dim, italic, underline, blink, inverse, off is 20 more */
+    static const uint8_t on[6] = { 1, 2, 3, 4, 5, 7 };
+    uint8_t had = vln_sgr_flags(from);
+    uint8_t want = vln_sgr_flags(to);
+    uint8_t i;
+
+    /*!< 22 ends both bold and dim */
+    if (had & ~want & 0x03) {
+        vln_sgr_pn(buf, idx, 22);
+        had &= ~0x03;
+    }
 
-/*****************************************************************************
-* @brief        move cursor to end of line
-* @retval int               0:Success -1:Error    
-*****************************************************************************/
-static int vln_edit_moveend(vln_t *vln)
-{
-    vln->ln.curoff = vln->ln.buff->size;
-    return vln_edit_refresh(vln);
-}
+    for (i = 0; i < 6; i++) {
+        if (had & ~want & (1u << i)) {
+            vln_sgr_pn(buf, idx, 20 + on[i]);
+        }
+    }
 
-/*****************************************************************************
-* @brief        delete the whole line
-* @retval int               0:Success -1:Error    
-*****************************************************************************/
-static int vln_edit_delline(vln_t *vln)
-{
-    vln->ln.buff->size = 0;
-    vln->ln.curoff = 0;
-    return vln_edit_refresh(vln);
-}
+    for (i = 0; i < 6; i++) {
+        if (want & ~had & (1u << i)) {
+            vln_sgr_pn(buf, idx, on[i]);
+        }
+    }
 
-/*****************************************************************************
-* @brief        delete from cursor to end of line
-* @retval int               0:Success -1:Error    
-*****************************************************************************/
-static int vln_edit_delend(vln_t *vln)
-{
-    vln->ln.buff->size = vln->ln.curoff;
-    return vln_edit_refresh(vln);
+    if (from.foreground != to.foreground) {
+        vln_sgr_color(buf, idx, 30, to.foreground);
+    }
+
+    if (from.background != to.background) {
+        vln_sgr_color(buf, idx, 40, to.background);
+    }
 }
 
 /*****************************************************************************
-* @brief        delete previosu word
-* @retval int               0:Success -1:Error    
+* @brief        output sgr from the session attributes to sgrraw, the shorter
+*               of the changes and a reset with all attributes, nothing if
+*               the terminal would show no difference
+* 
+* @param[in]    vln         
+* @param[in]    buf         buffer, VLN_SGR_MAX bytes after idx
+* @param[in]    idx         buffer index
+* @param[in]    sgrraw      sgr attributes, 0 to reset
 *****************************************************************************/
-static int vln_edit_delword(vln_t *vln)
+static void vln_sgr_update(vln_t *vln, uint8_t *buf, size_t *idx, uint64_t sgrraw)
 {
-    uint16_t curoff = vln->ln.curoff;
+    const vln_profile_t *pf = vln_profile_get(vln);
+    uint8_t colors = vln->sgr.colors ? vln->sgr.colors : pf->colors;
+    vln_sgr_t set = { .raw = sgrraw };
+    vln_sgr_t from = { .raw = vln->sgr.cur };
+    vln_sgr_t to = { .raw = 0 };
+    vln_sgr_t none = { .raw = 0 };
+    size_t delta = 0, reset = 2;
+
+    if (!pf->esc) {
+        return;
+    }
 
-    while ((curoff > 0) && (vln->ln.buff->pbuf[curoff] == ' ')) {
-        curoff--;
+    /*!< copy named fields only, unused bits never differ */
+    to.foreground = vln_sgr_fit(set.foreground, colors);
+    to.background = vln_sgr_fit(set.background, colors);
+    to.bold = set.bold;
+    to.dim = set.dim;
+    to.italic = set.italic;
+    to.underline = set.underline;
+    to.blink = set.blink;
+    to.inverse = set.inverse;
+
+    if (to.raw == from.raw) {
+        return;
     }
 
-    while ((curoff > 0) && (vln->ln.buff->pbuf[curoff] != ' ')) {
-        curoff--;
+    vln->sgr.cur = to.raw;
+    vln_seqgen_csi(buf, idx);
+
+    if (to.raw == 0) {
+        buf[(*idx)++] = 'm';
+        return;
     }
 
-    memmove(vln->ln.buff->pbuf + curoff,
-            vln->ln.buff->pbuf + vln->ln.curoff,
-            vln->ln.buff->size - vln->ln.curoff + 1);
-    vln->ln.buff->size -= vln->ln.curoff - curoff;
-    vln->ln.curoff = curoff;
+    vln_sgr_params(NULL, &delta, from, to);
+    vln_sgr_params(NULL, &reset, none, to);
 
-    return vln_edit_refresh(vln);
+    if (reset < delta) {
+        buf[(*idx)++] = '0';
+        buf[(*idx)++] = ';';
+        from = none;
+    }
+
+    vln_sgr_params(buf, idx, from, to);
+    buf[(*idx) - 1] = 'm';
 }
 
 /*---------------------------------------------------------------------------
-* @}            vln_edit
+* @}            vln_sgr
 ----------------------------------------------------------------------------*/
 
-/*****************************************************************************
-* @brief        show help
-* @retval int               0:Success -1:Error  
-*****************************************************************************/
-static int vln_help(vln_t *vln)
-{
-    if (sizeof(CFG_VLN_HELP) - 1) {
-        vln_put(vln, CFG_VLN_HELP, sizeof(CFG_VLN_HELP) - 1, -1);
-    }
-    return 0;
-}
-
-/** @addtogroup vln_dispatch
+/** @addtogroup vln_prompt
 -----------------------------------------------------------------------------
 * @{
 ----------------------------------------------------------------------------*/
 
 /*****************************************************************************
-* @brief        dispatch csi sequences
+* @brief        display width of string, escape sequences, control codes 
+*               and utf-8 continuation bytes take no column
 * 
-* @param[in]    vln         
-* @param[inout] c           character for dispatch
-* @param[in]    pns         params for dispatch
+* @param[in]    str         string
+* @param[in]    len         string length
 * 
-* @retval int               0:Success -1:Error
+* @retval uint16_t          display width
 *****************************************************************************/
-static int vln_dispatch_csi(vln_t *vln, uint8_t *c, uint16_t *pns)
+static uint16_t vln_prompt_width(const char *str, uint16_t len)
 {
-    uint8_t idx;
+    uint8_t c;
+    uint8_t state = 0;
+    uint16_t width = 0;
+
+    while (len--) {
+        c = *str++;
+
+        if (state == 1) {
+            /*!< two byte escape sequence, or csi */
+            state = (c == '[') ? 2 : 0;
+        } else if (state == 2) {
+            /*!< csi ends with final byte */
+            if ((0x40 <= c) && (c <= 0x7e)) {
+                state = 0;
+            }
+        } else if (c == VLN_C0_ESC) {
+            state = 1;
+        } else if ((c >= VLN_G0_BEG) && (c != VLN_C0_DEL) && ((c & 0xc0) != 0x80)) {
+            width++;
+        }
+    }
 
-    if (*c == '~') {
-        if (pns[0] >= sizeof(vtmap)) {
-            pns[0] = 0;
+    return width;
+}
+
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+/*****************************************************************************
+* @brief        render prompt template, left segment followed by right
+*               segment, into the half of the render buffer not on screen.
+*               the halves are swapped only if the bytes differ
+* 
+* @param[in]    vln         
+* 
+* @retval uint8_t           1:rendered bytes changed 0:same as shown
+*****************************************************************************/
+static uint8_t vln_prompt_render(vln_t *vln)
+{
+    const char *tmpl = vln->ppt.tmpl;
+    char *pbuf = vln->ppt.pbuf;
+    uint16_t size = vln->ppt.size - 1; /*!< reserved for \0 */
+    uint16_t len = 0;
+    uint16_t left = UINT16_MAX;
+    uint16_t ret;
+    uint8_t i;
+
+    for (; (*tmpl != '\0') && (len < size); tmpl++) {
+        if ((*tmpl != '%') || (tmpl[1] == '\0')) {
+            pbuf[len++] = *tmpl;
+            continue;
         }
 
-        *c = vtmap[pns[0]];
-    } else if (*c == 't') {
-        if (pns[0] == 8) {
-            vln->term.nsupt = 0;
-            vln->term.row = pns[1];
-            vln->term.col = pns[2];
-            /*!< 1.enter alternate screen buffer <esc>[?47h */
-            /*!< 2.clear screen buffer           <esc>[2J   */
-            /*!< 3.move cursor to (1,1)          <esc>[1;1H */
-            /*!< 4.enter normal screen buffer    <esc>[?47l */
-            vln_put(vln, "\e[?47h\e[2J\e[1;1H", 16, -1);
-            vln_help(vln);
-            vln_put(vln, "\e[?47l", 6, -1);
+        tmpl++;
+
+        /*!< start of right segment */
+        if (*tmpl == '>') {
+            if (left == UINT16_MAX) {
+                left = len;
+            }
+            continue;
         }
 
-        *c = VLN_EXEC_NUL;
-    } else {
-        idx = *c - 0x40;
-        if (idx >= sizeof(xmap)) {
-            idx = 0;
+        for (i = 0; i < vln->ppt.nvars; i++) {
+            if (vln->ppt.vars[i].key == *tmpl) {
+                break;
+            }
         }
 
-        *c = xmap[idx];
+        if (i < vln->ppt.nvars) {
+            ret = vln->ppt.vars[i].render(vln->ppt.vars[i].arg, pbuf + len, size - len);
+            len += ret > (size - len) ? (size - len) : ret;
+        } else {
+            /*!< %% and unknown placeholder */
+            pbuf[len++] = *tmpl;
+        }
     }
 
-    return 0;
+    pbuf[len] = '\0';
+
+    if (left == UINT16_MAX) {
+        left = len;
+    }
+
+    /*!< placeholders changed but rendered the same */
+    if ((left == vln->ln.pptlen) && ((len - left) == vln->ppt.rptlen) &&
+        !memcmp(pbuf, vln->prompt, len)) {
+        return 0;
+    }
+
+    vln->ppt.pbuf = vln->prompt;
+    vln->prompt = pbuf;
+    vln->ln.pptlen = left;
+    vln->ppt.rptlen = len - left;
+    return 1;
 }
 
 /*****************************************************************************
-* @brief        dispatch o sequences
+* @brief        ms until placeholders are due to be polled while idle
 * 
 * @param[in]    vln         
-* @param[inout] c           character for dispatch
-* @param[in]    pns         params for dispatch     
 * 
-* @retval int               0:Success -1:Error
+* @retval uint32_t          timeout in ms, VLN_WAIT_FOREVER if no placeholder
+*                           has a poll callback
 *****************************************************************************/
-static int vln_dispatch_o(vln_t *vln, uint8_t *c, uint16_t *pns)
+static uint32_t vln_prompt_wait(vln_t *vln)
 {
-    (void)vln;
-    (void)pns;
-    *c = VLN_EXEC_NUL;
+    uint32_t past;
+    uint8_t i;
 
-    return 0;
+    for (i = 0; i < vln->ppt.nvars; i++) {
+        if (NULL != vln->ppt.vars[i].poll) {
+            break;
+        }
+    }
+
+    if (i == vln->ppt.nvars) {
+        return VLN_WAIT_FOREVER;
+    }
+
+    /*!< without a tick poll on every wake */
+    if (NULL == vln->tick) {
+        return 0;
+    }
+
+    past = vln->tick() - vln->ppt.tick;
+    return (past < CFG_VLN_PROMPT_POLL) ? CFG_VLN_PROMPT_POLL - past : 0;
 }
 
 /*****************************************************************************
-* @brief        dispatch alt sequences
+* @brief        check right segment fits after line end
 * 
 * @param[in]    vln         
-* @param[inout] c           character for dispatch
-* @param[in]    pns         params for dispatch     
-* 
-* @retval int               0:Success -1:Error
+* @param[in]    end         line end column
 *****************************************************************************/
-static int vln_dispatch_alt(vln_t *vln, uint8_t *c, uint16_t *pns)
+static uint8_t vln_prompt_rfits(vln_t *vln, uint16_t end)
 {
-    (void)vln;
-    (void)pns;
-    *c = VLN_EXEC_NUL;
+    const vln_profile_t *pf = vln_profile_get(vln);
 
-    return 0;
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+    /*!< rows below the prompt have no right segment */
+    if (vln->ln.wrap) {
+        return 0;
+    }
+#endif
+
+    /*!< right segment is placed with ED and CUF */
+    return vln->ppt.rptlen && pf->esc && pf->rel && ((end + 1 + vln->ppt.rptoff) <= vln->term.col);
 }
+#endif
 
 /*****************************************************************************
-* @brief        dispatch ctrl sequences
+* @brief        poll placeholders, recalculate prompt strlen and width only
+*               if something changed
 * 
 * @param[in]    vln         
-* @param[inout] c           character for dispatch
-* @param[in]    pns         params for dispatch     
 * 
-* @retval int               0:Success -1:Error
+* @retval uint8_t           1:prompt changed 0:unchanged
 *****************************************************************************/
-static int vln_dispatch_ctrl(vln_t *vln, uint8_t *c, uint16_t *pns)
+static uint8_t vln_prompt_poll(vln_t *vln)
 {
-    (void)vln;
-    (void)c;
-    (void)pns;
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    uint8_t i;
 
-    *c = c0map[*c];
+    if (NULL != vln->tick) {
+        vln->ppt.tick = vln->tick();
+    }
 
-    return 0;
+    for (i = 0; i < vln->ppt.nvars; i++) {
+        if ((NULL != vln->ppt.vars[i].poll) &&
+            vln->ppt.vars[i].poll(vln->ppt.vars[i].arg)) {
+            vln->ppt.dirty = 1;
+        }
+    }
+#endif
+
+    if (!vln->ppt.dirty) {
+        return 0;
+    }
+
+    vln->ppt.dirty = 0;
+
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    if (NULL != vln->ppt.tmpl) {
+        if (!vln_prompt_render(vln)) {
+            return 0;
+        }
+
+        vln->ppt.rptoff = vln_prompt_width(vln->prompt + vln->ln.pptlen, vln->ppt.rptlen);
+        vln->ln.pptoff = vln_prompt_width(vln->prompt, vln->ln.pptlen);
+        return 1;
+    }
+#endif
+
+    vln->ln.pptlen = strlen(vln->prompt);
+    vln->ln.pptoff = vln_prompt_width(vln->prompt, vln->ln.pptlen);
+
+    return 1;
 }
 
 /*---------------------------------------------------------------------------
-* @}            vln_dispatch
+* @}            vln_prompt
 ----------------------------------------------------------------------------*/
 
-/** @addtogroup vln_seq_execute
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+/** @addtogroup vln_status
 -----------------------------------------------------------------------------
 * @{
 ----------------------------------------------------------------------------*/
 
 /*****************************************************************************
-* @brief        parse csi sequences
-* 
-* @param[in]    vln         
-* @param[out]   csiend      final csi seq character
-* @param[out]   expre       extend prefix character
-* @param[out]   pns         array of number param
-* 
-* @retval int               0:Success -1:Error
+* @brief        check a status change waits to be drawn, never while the
+*               pager owns the screen and the saved cursor
 *****************************************************************************/
-static int vln_seqexec_pcsi(vln_t *vln, uint8_t *csiend, uint8_t *expre, uint16_t *pns)
+static uint8_t vln_status_held(vln_t *vln)
 {
-    uint8_t csibuf[8];
-    uint8_t *pbuf = csibuf;
-
-    vln_waitkey(vln, pbuf);
-
-    if (('0' <= *pbuf) && (*pbuf <= '9')) {
-        pbuf++;
-    } else if ('?' == *pbuf) {
-        *expre = *pbuf;
-    } else if ((('a' <= *pbuf) && (*pbuf <= 'z')) ||
-               (('A' <= *pbuf) && (*pbuf <= 'Z'))) {
-        *csiend = *pbuf;
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+    if (NULL != vln->pgr.cb) {
         return 0;
     }
+#endif
 
-    for (;;) {
-        vln_waitkey(vln, pbuf);
-
-        if (('0' <= *pbuf) && (*pbuf <= '9')) {
-            pbuf++;
-        } else if (*pbuf == ';') {
-            pbuf = csibuf;
-            vln_parse_integer(csibuf, pns++);
-        } else if ((*pbuf == '~') ||
-                   (('a' <= *pbuf) && (*pbuf <= 'z')) ||
-                   (('A' <= *pbuf) && (*pbuf <= 'Z'))) {
-            *csiend = *pbuf;
-            vln_parse_integer(csibuf, pns++);
-            return 0;
-        } else {
-            return -1;
-        }
-    }
+    return (NULL != vln->sts.shown) && vln->sts.dirty;
 }
 
 /*****************************************************************************
-* @brief        execute CSI sequences
-* 
-* @param[in]    vln         
-* @param[out]   c           character for dispatch
-* @param[out]   pns         array of number param
-* 
-* @retval int               0:Success -1:Error
+* @brief        status row was erased, draw all of it at the next poll
+*               regardless of the interval
 *****************************************************************************/
-static int vln_seqexec_csi(vln_t *vln, uint8_t *c, uint16_t *pns)
+static void vln_status_lost(vln_t *vln)
 {
-    uint8_t expre = 0;
-
-    if (vln_seqexec_pcsi(vln, c, &expre, pns)) {
-        return -1;
+    if (NULL == vln->sts.shown) {
+        return;
     }
 
-    if (expre) {
-        *c = VLN_C0_NUL;
+    if (!vln->sts.dirty) {
+        memcpy(vln->sts.next, vln->sts.shown, vln->sts.width);
     }
 
-    return vln_dispatch_csi(vln, c, pns);
+    /*!< no cell matches, all are sent */
+    memset(vln->sts.shown, 0, vln->sts.width);
+    vln->sts.dirty = 1;
+
+    if (NULL != vln->tick) {
+        vln->sts.tick = vln->tick() - CFG_VLN_STATUS_INTERVAL;
+    }
 }
 
 /*****************************************************************************
-* @brief        execute ALT sequences
-* 
-* @param[in]    vln         
-* @param[inout]   c         character for dispatch
-* @param[out]   pns         array of number param
-* 
+* @brief        send the cells of next that differ from shown, the first run
+*               is reached by CUP and later ones by CUF, gaps of up to 4
+*               equal cells are sent again as they cost less than CUF, and
+*               more than 3 trailing spaces are one EL. the cursor is saved
+*               and restored around it, so the line being edited is not
+*               touched
 * @retval int               0:Success -1:Error
 *****************************************************************************/
-static int vln_seqexec_alt(vln_t *vln, uint8_t *c, uint16_t *pns)
+static int vln_status_draw(vln_t *vln)
 {
-    return vln_dispatch_alt(vln, c, pns);
+    char *next = vln->sts.next;
+    char *shown = vln->sts.shown;
+    uint16_t cells = (vln->sts.width < vln->term.col) ? vln->sts.width : vln->term.col;
+    uint16_t at = VLN_OFF_NONE;
+    uint16_t tail = cells;
+    uint16_t i, end, scan, stop;
+    uint8_t out[64];
+    size_t idx = 0;
+
+    vln->sts.dirty = 0;
+    if (NULL != vln->tick) {
+        vln->sts.tick = vln->tick();
+    }
+
+    /*!< spaces from tail on */
+    while ((tail > 0) && (' ' == next[tail - 1])) {
+        tail--;
+    }
+
+    for (i = 0; i < cells; i = end) {
+        if (next[i] == shown[i]) {
+            end = i + 1;
+            continue;
+        }
+
+        /*!< run ends before 5 equal cells, or where EL may take over */
+        stop = ((i < tail) && ((cells - tail) > 3)) ? tail : cells;
+        end = i + 1;
+        for (scan = end; (scan < stop) && ((scan - end) < 5); scan++) {
+            if (next[scan] != shown[scan]) {
+                end = scan + 1;
+            }
+        }
+
+        if (idx > (sizeof(out) - 16)) {
+            vln_put(vln, out, idx, -1);
+            idx = 0;
+        }
+
+        if (VLN_OFF_NONE == at) {
+            /*!< status cells plain, not in the sgr left by the line,
+                 <esc>8 brings that back */
+            out[idx++] = '\e';
+            out[idx++] = '7';
+            vln_seqgen_csi0(out, &idx, 'm');
+            vln_seqgen_cursor_position(out, &idx, vln->sts.row, i + 1);
+        } else if (i != at) {
+            vln_seqgen_cursor_forward(out, &idx, i - at);
+        }
+
+        /*!< blank the rest of the row */
+        if ((i >= tail) && ((end - i) > 3)) {
+            vln_seqgen_csi0(out, &idx, 'K');
+            memset(shown + i, ' ', cells - i);
+            at = cells;
+            break;
+        }
+
+        if ((idx + end - i) > sizeof(out)) {
+            vln_put(vln, out, idx, -1);
+            vln_put(vln, next + i, end - i, -1);
+            idx = 0;
+        } else {
+            memcpy(out + idx, next + i, end - i);
+            idx += end - i;
+        }
+
+        memcpy(shown + i, next + i, end - i);
+        at = end;
+    }
+
+    if (VLN_OFF_NONE == at) {
+        return 0;
+    }
+
+    if (idx > (sizeof(out) - 2)) {
+        vln_put(vln, out, idx, -1);
+        idx = 0;
+    }
+
+    out[idx++] = '\e';
+    out[idx++] = '8';
+    vln_put(vln, out, idx, -1);
+
+    return 0;
 }
 
 /*****************************************************************************
-* @brief        execute O sequences
-* 
-* @param[in]    vln         
-* @param[out]   c           character for dispatch
-* @param[out]   pns         array of number param
-* 
+* @brief        draw a held status change once CFG_VLN_STATUS_INTERVAL ms
+*               passed since the last one, called between keys
 * @retval int               0:Success -1:Error
 *****************************************************************************/
-static int vln_seqexec_o(vln_t *vln, uint8_t *c, uint16_t *pns)
+static int vln_status_poll(vln_t *vln)
 {
-    vln_waitkey(vln, c);
+    if (!vln_status_held(vln)) {
+        return 0;
+    }
+
+    if ((NULL != vln->tick) && ((vln->tick() - vln->sts.tick) < CFG_VLN_STATUS_INTERVAL)) {
+        return 0;
+    }
 
-    return vln_dispatch_o(vln, c, pns);
+    return vln_status_draw(vln);
 }
 
 /*****************************************************************************
-* @brief        execute sequences
-* 
-* @param[in]    vln         
-* @param[inout] c           character for dispatch
-* @param[out]   pns         array of number param
-* 
+* @brief        set the scroll region above the status row again, after a
+*               resize or when the terminal lost it
 * @retval int               0:Success -1:Error
 *****************************************************************************/
-static int vln_seqexec(vln_t *vln, uint8_t *c, uint16_t *pns)
+static int vln_status_region(vln_t *vln)
 {
-    vln_waitkey(vln, c);
+    uint8_t seq[24];
+    size_t idx = 0;
 
-    switch (*c) {
-        case 'O':
-            return vln_seqexec_o(vln, c, pns);
-        case '[':
-            return vln_seqexec_csi(vln, c, pns);
-        default:
-            return vln_seqexec_alt(vln, c, pns);
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+    /*!< the pager has its own region and sets this one when closed */
+    if (NULL != vln->pgr.cb) {
+        vln_status_lost(vln);
+        return 0;
     }
+#endif
 
+    /*!< 1.save cursor, DECSTBM homes it <esc>7     */
+    /*!< 2.rows above status scroll      <esc>[1;nr */
+    /*!< 3.restore cursor                <esc>8     */
+    seq[idx++] = '\e';
+    seq[idx++] = '7';
+    vln_seqgen_csi2(seq, &idx, 'r', 1, vln->term.row);
+    seq[idx++] = '\e';
+    seq[idx++] = '8';
+    vln_put(vln, seq, idx, -1);
+
+    vln_status_lost(vln);
     return 0;
 }
 
 /*---------------------------------------------------------------------------
-* @}            vln_seq_execute
+* @}            vln_status
 ----------------------------------------------------------------------------*/
+#endif
 
-#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
-
-/** @addtogroup vln_history
+/** @addtogroup vln_edit
 -----------------------------------------------------------------------------
 * @{
 ----------------------------------------------------------------------------*/
 
 /*****************************************************************************
-* @brief        reverse memcpy 4byte align
-* 
-* @param[in]    dst         
-* @param[in]    src         
-* @param[in]    n           byte
-* 
+* @brief        mark line changed from offset
 *****************************************************************************/
-static void vln_rvsememcpy4(void *dst, const void *src, size_t n)
+static void vln_edit_dirty(vln_t *vln, uint16_t off)
 {
-    uint32_t *pout = dst;
-    uint32_t *pin = (uint32_t *)src - 1;
-
-    for (; n > 0; n -= 4) {
-        *pout++ = *pin--;
+    if (off < vln->ln.dirty) {
+        vln->ln.dirty = off;
     }
 }
 
 /*****************************************************************************
-* @brief        align 4 up
-* 
-* @param[in]    size        size
-* 
-* @retval                   align size
+* @brief        forget screen state, next refresh redraw whole line
 *****************************************************************************/
-static uint32_t vln_align4(uint32_t size)
+static void vln_edit_invalidate(vln_t *vln)
 {
-    if (size & 0x3) {
-        return (size & ~0x3) + 4;
-    } else {
-        return size;
-    }
+    vln->ln.dirty = 0;
+    vln->ln.drawn = VLN_OFF_NONE;
+    vln->ln.cursor = VLN_OFF_NONE;
 }
 
 /*****************************************************************************
-* @brief        cache linbuff to history list
+* @brief        output spaces at screen cursor, cursor is not tracked
 * 
 * @param[in]    vln         
+* @param[in]    n           count of spaces
 * 
+* @retval int               0:Success -1:Error
 *****************************************************************************/
-static void vln_history_cache(vln_t *vln)
+static int vln_edit_spaces(vln_t *vln, uint16_t n)
 {
-    uint16_t unused;
-    uint16_t offset;
-    uint16_t remain;
-    uint16_t lnsize;
-    uint8_t *dst;
-
-    /*!< fifo unused size */
-    unused = vln->hist.size - (vln->hist.cache - vln->hist.out);
-
-    /*!< line and size total size, alignup 4 */
-    lnsize = vln_align4(vln->ln.buff->size + 4);
+    uint16_t step;
 
-    /*!< free the oldest history */
-    if (lnsize > unused) {
-        vln->hist.out += lnsize - unused;
+    for (; n; n -= step) {
+        step = n > (uint16_t)sizeof(spaces) ? (uint16_t)sizeof(spaces) : n;
+        vln_put(vln, (void *)spaces, step, -1);
     }
 
-    /*!< fifo write offset */
-    offset = vln->hist.cache & vln->hist.mask;
-
-    /*!< unused size before ringloop */
-    remain = vln->hist.size - offset;
-    remain = remain > lnsize ? lnsize : remain;
-
-    dst = (uint8_t *)(vln->ln.buff) + lnsize;
-
-    vln_rvsememcpy4(vln->hist.pbuf + offset, dst, remain);
-    vln_rvsememcpy4(vln->hist.pbuf, dst - remain, lnsize - remain);
-
-    vln->hist.in = vln->hist.cache + lnsize;
+    return 0;
 }
 
 /*****************************************************************************
-* @brief        store linebuff to history list
-* 
-* @param[in]    vln         
-*                
+* @brief        check cursor can move forward by writing the cells again,
+*               line text is written as is, a dumb terminal has no other
+*               way and also writes spaces past the line
 *****************************************************************************/
-static void vln_history_store(vln_t *vln)
+static uint8_t vln_edit_reprintable(vln_t *vln, const vln_profile_t *pf, uint16_t from, uint16_t to)
 {
-    if (vln->ln.buff->size > 0) {
-        vln_history_cache(vln);
+    if (from < vln->ln.pptoff) {
+        return 0;
+    }
 
-        /*!< update cache index */
-        vln->hist.cache = vln->hist.in;
+    if (!pf->rel) {
+        return 1;
     }
+
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+    /*!< attributes would cost more than the cells */
+    if (vln->hl.nspan) {
+        return 0;
+    }
+#endif
+
+    return (vln->ln.winoff + to - vln->ln.pptoff) <= vln->ln.buff->size;
 }
 
 /*****************************************************************************
-* @brief        load special index history to linebuff
+* @brief        cheapest relative move between known columns
 * 
 * @param[in]    vln         
-* @param[in]    index       history index
+* @param[in]    pf          output profile
+* @param[in]    from        cursor column
+* @param[in]    to          target column
+* @param[out]   how         BS, space for reprint, 'C' CUF or 'D' CUB
 * 
-* @retval                   0:Success -1:Error
+* @retval uint16_t          cost in bytes, VLN_COST_NONE if not possible
 *****************************************************************************/
-static int vln_history_load(vln_t *vln, uint16_t index)
+static uint16_t vln_edit_relcost(vln_t *vln, const vln_profile_t *pf, uint16_t from, uint16_t to, uint8_t *how)
 {
-    uint16_t used;
-    uint16_t offset;
-    uint16_t remain;
-    uint16_t lnsize;
-    uint16_t histin;
-    uint16_t count;
-    uint16_t prevused;
+    uint16_t n = (from > to) ? from - to : to - from;
+    uint16_t cost = VLN_COST_NONE;
 
-    if (vln->hist.index == 0) {
-        vln_history_cache(vln);
+    *how = 0;
+
+    if (n == 0) {
+        return 0;
     }
 
-    lnsize = 0;
-    count = index;
-    histin = vln->hist.in;
-    prevused = vln->hist.in - vln->hist.out;
+    if (pf->rel) {
+        cost = pf->rel + ((n > 1) ? vln_print_width(n) : 0);
+        *how = (from > to) ? 'D' : 'C';
+    }
 
-    do {
-        histin -= lnsize;
+    if (from > to) {
+        if (pf->bs && (((uint32_t)pf->bs * n) < cost)) {
+            cost = pf->bs * n;
+            *how = '\b';
+        }
+    } else if ((n < cost) && vln_edit_reprintable(vln, pf, from, to)) {
+        cost = n;
+        *how = ' ';
+    }
 
-        /*!< fifo used size */
-        used = histin - vln->hist.out;
+    return cost;
+}
 
-        if ((used == 0) || (used > prevused)) {
-            return 0;
+/*****************************************************************************
+* @brief        relative move chosen by vln_edit_relcost
+* 
+* @param[in]    vln         
+* @param[in]    from        cursor column
+* @param[in]    to          target column
+* @param[in]    how         move from vln_edit_relcost
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_relmove(vln_t *vln, uint16_t from, uint16_t to, uint8_t how)
+{
+    static const char bs[8] = "\b\b\b\b\b\b\b\b";
+    uint16_t n = (from > to) ? from - to : to - from;
+    uint16_t off, end, text;
+    size_t idx = 0;
+    uint8_t seq[8];
+
+    if (n == 0) {
+        /*!< already there */
+    } else if (how == '\b') {
+        for (; n; n -= off) {
+            off = n > (uint16_t)sizeof(bs) ? (uint16_t)sizeof(bs) : n;
+            vln_put(vln, (void *)bs, off, -1);
+        }
+    } else if (how == ' ') {
+        /*!< line text, then spaces past the line */
+        off = vln->ln.winoff + from - vln->ln.pptoff;
+        end = vln->ln.winoff + to - vln->ln.pptoff;
+        text = (end > vln->ln.buff->size) ? vln->ln.buff->size : end;
+
+        if (off < text) {
+            if (vln_edit_output(vln, off, text)) {
+                return -1;
+            }
+            off = text;
         }
 
-        prevused = used;
+        if ((off < end) && vln_edit_spaces(vln, end - off)) {
+            return -1;
+        }
+    } else {
+        if (n > 1) {
+            vln_seqgen_csi1(seq, &idx, how, n);
+        } else {
+            vln_seqgen_csi0(seq, &idx, how);
+        }
+        vln_put(vln, seq, idx, -1);
+    }
 
-        /*!< fifo read offset */
-        offset = (histin - 4) & vln->hist.mask;
+    vln->ln.cursor = to;
+    return 0;
+}
 
-        /*!< read fisrt 4byte and alignup 4 */
-        lnsize = vln_align4(((uint32_t *)(vln->hist.pbuf + offset))[0] + 4);
+/*****************************************************************************
+* @brief        move screen cursor to column if not there, the cheapest of
+*               CHA, a relative move, or CR with prompt and a relative move
+*               that the output profile supports. a wrapped line counts
+*               cells from the prompt start, the row is changed first
+* 
+* @param[in]    vln         
+* @param[in]    col         column, or cell of a wrapped line, start from 0
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_cursor(vln_t *vln, uint16_t col)
+{
+    const vln_profile_t *pf = vln_profile_get(vln);
+    uint16_t cur = vln->ln.cursor;
+    uint16_t base = 0;
+    uint32_t cost = VLN_COST_NONE;
+    uint32_t crcost;
+    uint8_t how = 0;
+    uint8_t crhow;
+    size_t idx = 0;
+    uint8_t seq[8];
+
+    if (cur == col) {
+        return 0;
+    }
 
-        if (lnsize > used) {
-            return 0;
-        }
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+    if (vln->ln.wrap) {
+        /*!< first cell of target row */
+        base = col - col % vln->term.col;
 
-    } while (count--);
+        if ((cur != VLN_OFF_NONE) && ((cur / vln->term.col) != (col / vln->term.col))) {
+            if (cur > col) {
+                vln_seqgen_csi1(seq, &idx, 'A', cur / vln->term.col - col / vln->term.col);
+            } else {
+                vln_seqgen_csi1(seq, &idx, 'B', col / vln->term.col - cur / vln->term.col);
+            }
+            vln_put(vln, seq, idx, -1);
 
-    offset = (histin - lnsize) & vln->hist.mask;
+            cur = base + cur % vln->term.col;
+            vln->ln.cursor = cur;
+            if (cur == col) {
+                return 0;
+            }
+        }
+    }
+#endif
 
-    /*!< unused size before ringloop */
-    remain = vln->hist.size - offset;
-    remain = remain > lnsize ? lnsize : remain;
+    /*!< unknown, or pending wrap at last column where relative moves are off by one */
+    if ((cur != VLN_OFF_NONE) && ((uint16_t)(cur - base) < vln->term.col)) {
+        cost = vln_edit_relcost(vln, pf, cur, col, &how);
+    }
 
-    /*!< temp value */
-    lnsize = lnsize - remain;
+    if (pf->cha && ((uint32_t)(pf->cha + vln_print_width(col - base + 1)) <= cost)) {
+        cost = pf->cha + vln_print_width(col - base + 1);
+        how = 'G';
+    }
 
-    vln_rvsememcpy4((uint8_t *)(vln->ln.buff) + lnsize,
-                    vln->hist.pbuf + offset + remain, remain);
+    /*!< prompt is reprinted only on its own row */
+    if (base == 0) {
+        crcost = vln_edit_relcost(vln, pf, vln->ln.pptoff, col, &crhow);
+        if ((crcost != VLN_COST_NONE) && ((pf->cr + vln->ln.pptlen + crcost) < cost)) {
+            if (vln_edit_sgr(vln, 0)) {
+                return -1;
+            }
 
-    vln_rvsememcpy4(vln->ln.buff, vln->hist.pbuf + lnsize, lnsize);
+            vln_put(vln, "\r", 1, -1);
+            vln_put(vln, vln->prompt, vln->ln.pptlen, -1);
+            vln->ln.cursor = vln->ln.pptoff;
+            return vln_edit_relmove(vln, vln->ln.pptoff, col, crhow);
+        }
+    } else {
+        crcost = vln_edit_relcost(vln, pf, base, col, &crhow);
+        if ((crcost != VLN_COST_NONE) && ((pf->cr + crcost) < cost)) {
+            vln_put(vln, "\r", 1, -1);
+            vln->ln.cursor = base;
+            return vln_edit_relmove(vln, base, col, crhow);
+        }
+    }
 
-    vln->ln.curoff = vln->ln.buff->size;
-    vln->hist.index = index;
-    return vln_edit_refresh(vln);
+    if (how == 'G') {
+        idx = 0;
+        vln_seqgen_cursor_absolute(seq, &idx, col - base + 1);
+        vln_put(vln, seq, idx, -1);
+        vln->ln.cursor = col;
+        return 0;
+    }
+
+    return vln_edit_relmove(vln, cur, col, how);
 }
 
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
 /*****************************************************************************
-* @brief        load prev history to linebuff
-* 
-* @param[in]    vln         
-*
-* @retval                   0:Success -1:Error
+* @brief        check line should be laid out over rows, the profile must
+*               move the cursor up and the rows must fit on screen
 *****************************************************************************/
-static int vln_history_loadprev(vln_t *vln)
+static uint8_t vln_edit_wraps(vln_t *vln)
 {
-    uint16_t lnhist = vln->hist.index + 1;
+    const vln_profile_t *pf = vln_profile_get(vln);
 
-    return vln_history_load(vln, lnhist);
+    return pf->rel && pf->esc &&
+           (((uint32_t)vln->ln.pptoff + vln->ln.buff->size) / vln->term.col < vln->term.row);
 }
+#endif
 
 /*****************************************************************************
-* @brief        load next history to linebuff
-* 
-* @param[in]    vln         
-*
-* @retval                   0:Success -1:Error
+* @brief        move cursor up to the prompt row of a wrapped line
+* @retval int               0:Success -1:Error
 *****************************************************************************/
-static int vln_history_loadnext(vln_t *vln)
+static int vln_edit_home(vln_t *vln)
 {
-    uint16_t lnhist = vln->hist.index > 0 ? vln->hist.index - 1 : 0;
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+    size_t idx = 0;
+    uint8_t seq[8];
+
+    if (vln->ln.wrap && (vln->ln.cursor != VLN_OFF_NONE) && (vln->ln.cursor >= vln->term.col)) {
+        vln_seqgen_csi1(seq, &idx, 'A', vln->ln.cursor / vln->term.col);
+        vln_put(vln, seq, idx, -1);
+        vln->ln.cursor %= vln->term.col;
+    }
+#else
+    (void)vln;
+#endif
 
-    return vln_history_load(vln, lnhist);
+    return 0;
 }
 
-/*---------------------------------------------------------------------------
-* @}            vln_history
-----------------------------------------------------------------------------*/
+/*****************************************************************************
+* @brief        move cursor after the last drawn cell of a wrapped line, so
+*               output below does not land inside the line
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_leave(vln_t *vln)
+{
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+    uint16_t end = vln->ln.buff->size;
+
+    if (vln->ln.wrap && (vln->ln.cursor != VLN_OFF_NONE)) {
+        if ((vln->ln.drawn != VLN_OFF_NONE) && (vln->ln.drawn > end)) {
+            end = vln->ln.drawn;
+        }
+        return vln_edit_cursor(vln, vln->ln.pptoff + end);
+    }
+#else
+    (void)vln;
 #endif
 
+    return 0;
+}
+
 /*****************************************************************************
-* @brief        calculate prompt strlen and cursor offset
+* @brief        output prompt again from its row and forget screen state,
+*               the next refresh draws the whole line in the layout that
+*               fits now
+* @retval int               0:Success -1:Error
 *****************************************************************************/
-static void vln_calculate_prompt(vln_t *vln)
+static int vln_edit_restart(vln_t *vln)
 {
-    char c;
-    uint8_t flag;
+    if (vln_edit_home(vln) || vln_edit_sgr(vln, 0)) {
+        return -1;
+    }
 
-    flag = 0;
-    vln->ln.pptlen = 0;
-    vln->ln.pptoff = 0;
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+    vln->ln.wrap = vln_edit_wraps(vln);
+#endif
 
-    while (1) {
-        c = vln->prompt[vln->ln.pptlen];
+    vln_put(vln, "\r", 1, -1);
+    vln_put(vln, vln->prompt, vln->ln.pptlen, -1);
 
-        if (c == '\0') {
-            return;
-        } else if (c == '\e') {
-            flag = 1;
-        } else if (flag == 0) {
-            vln->ln.pptoff++;
-        } else if ((flag == 1) && (c == 'm')) {
-            flag = 0;
-        }
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    vln->ppt.shown = 0;
+#endif
+
+    vln_edit_invalidate(vln);
+    vln->ln.cursor = vln->ln.pptoff;
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        set screen attributes if changed
+* 
+* @param[in]    vln         
+* @param[in]    sgrraw      sgr attributes, 0 to reset
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_sgr(vln_t *vln, uint64_t sgrraw)
+{
+    size_t idx = 0;
+    uint8_t seq[VLN_SGR_MAX];
+
+    vln_sgr_update(vln, seq, &idx, sgrraw);
 
-        vln->ln.pptlen++;
+    if (idx) {
+        vln_put(vln, seq, idx, -1);
     }
+
+    return 0;
 }
 
 /*****************************************************************************
-* @brief        wait switch to altscreen
+* @brief        reset background before erase, erased cells take it
 * @retval int               0:Success -1:Error
 *****************************************************************************/
-__unused static int vln_wait_altscreen(vln_t *vln)
+static int vln_edit_sgrerase(vln_t *vln)
 {
-    uint32_t c = 0;
+    vln_sgr_t sgr = { .raw = vln->sgr.cur };
 
-    for (;;) {
-        vln_waitkey(vln, &c);
+    if (sgr.background) {
+        return vln_edit_sgr(vln, 0);
+    }
 
-        if ((c == VLN_C0_CR) || (c == VLN_C0_LF)) {
-            vln_put(vln, "\e[?47h", 6, -1);
-            vln->term.alt = 1;
-            return 0;
+    return 0;
+}
+
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+/*****************************************************************************
+* @brief        attributes at offset
+* 
+* @param[in]    spans       sorted spans
+* @param[in]    nspan       span count
+* @param[inout] i           span index hint, only moves forward
+* @param[in]    pos         offset
+* @param[out]   next        offset where attributes may change
+* 
+* @retval uint64_t          sgr attributes
+*****************************************************************************/
+static uint64_t vln_hl_attr(const vln_span_t *spans, uint8_t nspan, uint8_t *i, uint16_t pos, uint16_t *next)
+{
+    while ((*i < nspan) && ((spans[*i].off + spans[*i].len) <= pos)) {
+        (*i)++;
+    }
+
+    if (*i >= nspan) {
+        *next = VLN_OFF_NONE;
+        return 0;
+    }
+
+    if (spans[*i].off <= pos) {
+        *next = spans[*i].off + spans[*i].len;
+        return spans[*i].sgr;
+    }
+
+    *next = spans[*i].off;
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        rerun highlight on changed region, move dirty offset back to
+*               the first offset whose attributes differ from the screen
+*****************************************************************************/
+static void vln_hl_update(vln_t *vln)
+{
+    vln_span_t spans[CFG_VLN_HLSPAN];
+    uint16_t from;
+    uint16_t pos;
+    uint16_t onext;
+    uint16_t nnext;
+    uint8_t oi = 0;
+    uint8_t ni = 0;
+    uint8_t keep;
+    uint8_t n;
+
+    if ((NULL == vln->hl.cb) || (VLN_OFF_NONE == vln->ln.dirty)) {
+        return;
+    }
+
+    if (vln->ln.dirty > vln->ln.buff->size) {
+        vln->ln.dirty = vln->ln.buff->size;
+    }
+
+    from = vln->ln.dirty;
+    n = vln->hl.cb(vln->hl.arg, vln->ln.buff->pbuf, vln->ln.buff->size,
+                   &from, spans, CFG_VLN_HLSPAN);
+
+    if (from > vln->ln.dirty) {
+        from = vln->ln.dirty;
+    }
+
+    if (n > CFG_VLN_HLSPAN) {
+        n = CFG_VLN_HLSPAN;
+    }
+
+    /*!< unchanged text before dirty offset, redraw only if recolored */
+    for (pos = from; pos < vln->ln.dirty;) {
+        if (vln_hl_attr(vln->hl.spans, vln->hl.nspan, &oi, pos, &onext) !=
+            vln_hl_attr(spans, n, &ni, pos, &nnext)) {
+            break;
+        }
+
+        pos = onext < nnext ? onext : nnext;
+    }
+
+    if (pos < vln->ln.dirty) {
+        vln->ln.dirty = pos;
+    }
+
+    /*!< keep spans before rescan offset */
+    for (keep = 0; (keep < vln->hl.nspan) && (vln->hl.spans[keep].off < from); keep++) {
+        if ((vln->hl.spans[keep].off + vln->hl.spans[keep].len) > from) {
+            vln->hl.spans[keep].len = from - vln->hl.spans[keep].off;
         }
     }
+
+    for (ni = 0; (ni < n) && (keep < CFG_VLN_HLSPAN); ni++) {
+        vln->hl.spans[keep++] = spans[ni];
+    }
+
+    vln->hl.nspan = keep;
 }
+#endif
 
 /*****************************************************************************
-* @brief        readline internal
+* @brief        after output of a wrapped line filled the last column, take
+*               the cursor to the next row, terminals hold it in the last
+*               column until the next character
 * 
 * @param[in]    vln         
+* @param[in]    size        cells just output
 * 
-* @retval char*             line pointer
+* @retval int               0:Success -1:Error
 *****************************************************************************/
-static char *vln_inernal(vln_t *vln)
+static int vln_edit_rowend(vln_t *vln, uint16_t size)
 {
-#if defined(CFG_VLN_XTERM) && CFG_VLN_XTERM
-    /*!< wait switch to altscreen */
-    if (vln->term.altnsupt == 0) {
-        vln_wait_altscreen(vln);
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+    if (vln->ln.wrap && size && ((vln->ln.cursor % vln->term.col) == 0)) {
+        vln_put(vln, "\r\n", 2, -1);
     }
+#else
+    (void)vln;
+    (void)size;
 #endif
 
-    /*!< output prompt */
-    vln_put(vln, vln->prompt, vln->ln.pptlen, NULL);
+    return 0;
+}
 
-    while (1) {
-        uint8_t c = 0;
-        uint16_t pn[4];
+/*****************************************************************************
+* @brief        output part of linebuff with attributes at screen cursor
+* 
+* @param[in]    vln         
+* @param[in]    from        start offset
+* @param[in]    to          end offset
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_output(vln_t *vln, uint16_t from, uint16_t to)
+{
+    uint16_t size = to - from;
+    uint16_t next;
 
-#if defined(CFG_VLN_XTERM) && CFG_VLN_XTERM
-        /*!< wait switch to altscreen */
-        if (vln->term.altnsupt == 0) {
-            vln_wait_altscreen(vln);
-        }
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+    uint64_t sgrraw;
+    uint8_t i = 0;
 #endif
 
-        /*!< get a key */
-        vln_waitkey(vln, &c);
+    vln->ln.cursor += size;
 
-        if (c & 0x80) {
-            /*!< not support 8bit code */
-            continue;
+    if (vln->ln.buff->mask) {
+        if (vln_edit_spaces(vln, size)) {
+            return -1;
         }
+        return vln_edit_rowend(vln, size);
+    }
 
-        if (VLN_G0_BEG <= c) {
-            if (c <= VLN_G0_END) {
-                /*!< printable characters */
-                if (vln_edit_insert(vln, c)) {
-                    return NULL;
-                }
-                continue;
-            } else {
-                /*!< delete */
-                c = VLN_EXEC_BS;
-            }
-        } else if (VLN_C0_ESC == c) {
-            if (vln_seqexec(vln, &c, pn)) {
-                return NULL;
-            }
-        } else {
-            if (vln_dispatch_ctrl(vln, &c, pn)) {
-                return NULL;
-            }
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+    for (; from < to; from = next) {
+        sgrraw = vln_hl_attr(vln->hl.spans, vln->hl.nspan, &i, from, &next);
+        next = next > to ? to : next;
+
+        if (vln_edit_sgr(vln, sgrraw)) {
+            return -1;
         }
 
-        /*!< hanlder control */
-        switch (c) {
-            /*!< ignore */
-            default:
-            case VLN_EXEC_NUL:
-                break;
+        vln_put(vln, vln->ln.buff->pbuf + from, next - from, -1);
+    }
+#else
+    (void)next;
+    vln_put(vln, vln->ln.buff->pbuf + from, size, -1);
+#endif
 
-            /*!< clear screen and refresh line */
-            case VLN_EXEC_CLR:
-                if (vln_edit_clear(vln)) {
-                    return NULL;
-                }
-                break;
+    return vln_edit_rowend(vln, size);
+}
 
-            /*!< newline */
-            case VLN_EXEC_NLN:
-#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
-                vln_history_store(vln);
+/*****************************************************************************
+* @brief        erase from the cursor at offset end to the end of the drawn
+*               line. ED would take the status row too, so EL is used when
+*               the line ends on the cursor row, else the status row is
+*               drawn again after ED
+*****************************************************************************/
+static void vln_edit_erasebelow(vln_t *vln, uint8_t *seq, size_t *idx, uint16_t end)
+{
+    uint8_t final = 'J';
+
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    if (NULL != vln->sts.shown) {
+        final = 'K';
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+        if (vln->ln.wrap && ((VLN_OFF_NONE == vln->ln.drawn) ||
+                             (((vln->ln.pptoff + vln->ln.drawn - 1u) / vln->term.col) !=
+                              (end / vln->term.col)))) {
+            final = 'J';
+            vln_status_lost(vln);
+        }
+#endif
+    }
 #endif
-                return vln->ln.buff->pbuf;
 
-            /*!< abortline */
-            case VLN_EXEC_ALN:
-                vln->ln.buff->size = 0;
-                return vln->ln.buff->pbuf;
+    (void)vln;
+    (void)end;
+    vln_seqgen_csi0(seq, idx, final);
+}
 
-            /*!< delete */
-            case VLN_EXEC_DEL:
-                if (vln_edit_delete(vln)) {
-                    return NULL;
-                }
-                break;
+/*****************************************************************************
+* @brief        erase the rest of old line after line end
+* 
+* @param[in]    vln         
+* @param[in]    vis         visible size
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_erase(vln_t *vln, uint16_t vis)
+{
+    const vln_profile_t *pf = vln_profile_get(vln);
+    size_t idx = 0;
+    uint8_t seq[16];
+    uint16_t end = vln->ln.pptoff + vis;
+    uint16_t n;
 
-            /*!< backspace */
-            case VLN_EXEC_BS:
-                if (vln_edit_backspace(vln)) {
-                    return NULL;
-                }
-                break;
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    uint16_t diff;
 
-            /*!< move right */
-            case VLN_EXEC_MVRT:
-                if (vln_edit_moveright(vln)) {
-                    return NULL;
+    if (vln_prompt_rfits(vln, end)) {
+        diff = vln->term.col - vln->ppt.rptoff - end;
+
+        if (vln->ppt.shown) {
+            /*!< erase old characters up to right segment */
+            if (vln->ln.drawn > vis) {
+                if (vln_edit_cursor(vln, end) || vln_edit_sgrerase(vln)) {
+                    return -1;
                 }
-                break;
 
-            /*!< move left */
-            case VLN_EXEC_MVLT:
-                if (vln_edit_moveleft(vln)) {
-                    return NULL;
+                /*!< spaces cost the cells and the move back */
+                n = (vln->ln.drawn - vis) < diff ? (vln->ln.drawn - vis) : diff;
+                if (!pf->ech || ((2u * n) < (3u + vln_print_width(n)))) {
+                    vln->ln.cursor += n;
+                    return vln_edit_spaces(vln, n);
                 }
-                break;
 
-            /*!< move end */
-            case VLN_EXEC_MVED:
-                if (vln_edit_moveend(vln)) {
-                    return NULL;
-                }
-                break;
+                vln_seqgen_erase_char(seq, &idx, n);
+                vln_put(vln, seq, idx, -1);
+            }
+            return 0;
+        }
+
+        /*!< erase to end of display and output right segment */
+        if (vln_edit_cursor(vln, end) || vln_edit_sgr(vln, 0)) {
+            return -1;
+        }
+        vln_edit_erasebelow(vln, seq, &idx, end);
+        vln_seqgen_cursor_forward(seq, &idx, diff);
+        vln_put(vln, seq, idx, -1);
+        vln_put(vln, vln->prompt + vln->ln.pptlen, vln->ppt.rptlen, -1);
+        vln->ppt.shown = 1;
+
+        /*!< cursor may be pending wrap at last column */
+        vln->ln.cursor = VLN_OFF_NONE;
+        return 0;
+    }
+
+    if (!vln->ppt.shown && (vln->ln.drawn <= vis)) {
+        return 0;
+    }
+
+    vln->ppt.shown = 0;
+#else
+    if (vln->ln.drawn <= vis) {
+        return 0;
+    }
+#endif
+
+    /*!< erase to end of display */
+    if (vln_edit_cursor(vln, end) || vln_edit_sgrerase(vln)) {
+        return -1;
+    }
+
+    if (!pf->esc) {
+        /*!< overwrite with spaces, up to the last column if unknown */
+        if (vln->ln.drawn != VLN_OFF_NONE) {
+            n = vln->ln.drawn - vis;
+        } else {
+            n = ((end + 1) < vln->term.col) ? vln->term.col - end - 1 : 0;
+        }
+        vln->ln.cursor += n;
+        return vln_edit_spaces(vln, n);
+    }
+
+    vln_edit_erasebelow(vln, seq, &idx, end);
+    vln_put(vln, seq, idx, -1);
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        redraw line from the first changed offset only. one offset
+*               is tracked, not dirty rows: an insert or delete shifts every
+*               cell after it, so each row from the first changed one on
+*               would be dirty anyway
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_redraw(vln_t *vln)
+{
+    uint16_t curoff;
+    uint16_t pptoff;
+    uint16_t winoff;
+    uint16_t from;
+    uint16_t vis;
+
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+    uint16_t dirty;
+    uint16_t show;
+    uint8_t sugchg;
+#endif
+
+    if (vln->ln.buff == NULL) {
+        return 0;
+    }
+
+    curoff = vln->ln.curoff;
+    pptoff = vln->ln.pptoff;
+
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+    /*!< line crossed the screen height or the profile changed */
+    if ((vln_edit_wraps(vln) != vln->ln.wrap) && vln_edit_restart(vln)) {
+        return -1;
+    }
+
+    if (vln->ln.wrap) {
+        /*!< whole line on screen, cursor column is a cell from prompt start */
+        winoff = 0;
+        vis = vln->ln.buff->size;
+    } else
+#endif
+    {
+        /*!< slide visible window to keep cursor on screen */
+        winoff = ((pptoff + curoff) >= vln->term.col) ? (pptoff + curoff - vln->term.col + 1) : 0;
+
+        vis = vln->ln.buff->size - winoff;
+        if ((pptoff + vis) > vln->term.col) {
+            vis = vln->term.col - pptoff;
+        }
+    }
+
+    if (winoff != vln->ln.winoff) {
+        vln->ln.winoff = winoff;
+        vln->ln.dirty = 0;
+    }
+
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+    dirty = vln->ln.dirty;
+#endif
+
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+    if (!vln->ln.buff->mask) {
+        vln_hl_update(vln);
+    }
+#endif
+
+    if (vln->ln.dirty != VLN_OFF_NONE) {
+        from = vln->ln.dirty < winoff ? winoff : vln->ln.dirty;
+
+        /*!< output changed part of visible window */
+        if (from < (winoff + vis)) {
+            if (vln_edit_cursor(vln, pptoff + from - winoff) ||
+                vln_edit_output(vln, from, winoff + vis)) {
+                return -1;
+            }
+        }
+    }
+
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+    sugchg = vln_suggest_update(vln, dirty, vis, &show);
+
+    /*!< old suggestion is erased with the rest of line */
+    if (sugchg && ((vln->sug.from + vln->sug.shown) > vln->ln.drawn)) {
+        vln->ln.drawn = vln->sug.from + vln->sug.shown;
+    }
+
+    if (sugchg) {
+        vln_edit_dirty(vln, vln->ln.buff->size);
+    }
+#endif
+
+    if (vln->ln.dirty != VLN_OFF_NONE) {
+        if (vln_edit_erase(vln, vis)) {
+            return -1;
+        }
+
+        vln->ln.drawn = vis;
+        vln->ln.dirty = VLN_OFF_NONE;
+
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+        if (sugchg && vln_suggest_draw(vln, vis, show)) {
+            return -1;
+        }
+#endif
+    }
+
+    /*!< restore cursor */
+    return vln_edit_cursor(vln, pptoff + curoff - winoff);
+}
+
+/*****************************************************************************
+* @brief        refresh line, probed as render stage
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_refresh(vln_t *vln)
+{
+    int ret;
+
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    /*!< a streaming line is echoed a buffer at a time, never drawn */
+    if (vln->stm.on) {
+        return 0;
+    }
+#endif
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+    /*!< bytes after the cursor are parked, drawn when the paste ends */
+    if (vln->ln.paste) {
+        return 0;
+    }
+#endif
+
+    VLN_PROBE_BEGIN(vln, render);
+    ret = vln_edit_redraw(vln);
+    VLN_PROBE_END(vln, render, VLN_PROBE_RENDER);
+
+    return ret;
+}
+
+/*****************************************************************************
+* @brief        output prompt again and refresh line
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_reprompt(vln_t *vln)
+{
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    if (vln->stm.on) {
+        return 0;
+    }
+#endif
+
+    if (vln_edit_restart(vln)) {
+        return -1;
+    }
+
+    return vln_edit_refresh(vln);
+}
+
+/*****************************************************************************
+* @brief        clear screen and refresh line
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_edit_clear(vln_t *vln)
+{
+    if (vln_edit_sgr(vln, 0)) {
+        return -1;
+    }
+
+    if (vln_profile_get(vln)->esc) {
+        vln_put(vln, "\e[2J\e[1;1H", 10, -1);
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+        vln_status_lost(vln);
+#endif
+    } else {
+        /*!< nothing to clear with, start over on next line */
+        vln_put(vln, CFG_VLN_NEWLINE, sizeof(CFG_VLN_NEWLINE) - 1, -1);
+    }
+
+    /*!< output prompt */
+    vln_put(vln, vln->prompt, vln->ln.pptlen, -1);
+
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    vln->ppt.shown = 0;
+#endif
+
+    vln_edit_invalidate(vln);
+    vln->ln.drawn = 0;
+    vln->ln.cursor = vln->ln.pptoff;
+
+    return vln_edit_refresh(vln);
+}
+
+/*****************************************************************************
+* @brief        insert a character
+* @retval int               0:Success -1:Error        
+*****************************************************************************/
+static int vln_edit_insert(vln_t *vln, char c)
+{
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    if (vln->stm.on || (vln->ln.buff->size >= vln->ln.lnmax)) {
+        return vln_stream_insert(vln, c);
+    }
+#endif
+
+    if (vln->ln.buff->size < vln->ln.lnmax) {
+        VLN_UNDO_RECORD(vln, vln->ln.curoff, 0, &c, 1);
+
+        if (vln->ln.buff->size != vln->ln.curoff) {
+            memmove(vln->ln.buff->pbuf + vln->ln.curoff + 1,
+                    vln->ln.buff->pbuf + vln->ln.curoff,
+                    vln->ln.buff->size - vln->ln.curoff);
+        }
+
+        vln_edit_dirty(vln, vln->ln.curoff);
+        vln->ln.buff->pbuf[vln->ln.curoff++] = c;
+        vln->ln.buff->size++;
+
+        /*!< append costs only the character itself */
+        return vln_edit_refresh(vln);
+    }
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        delete cursor left character
+* @retval int               0:Success -1:Error    
+*****************************************************************************/
+static int vln_edit_backspace(vln_t *vln)
+{
+    if ((vln->ln.curoff > 0) && (vln->ln.buff->size > 0)) {
+        VLN_UNDO_RECORD(vln, vln->ln.curoff - 1, 1, NULL, 0);
+
+        memmove(vln->ln.buff->pbuf + vln->ln.curoff - 1,
+                vln->ln.buff->pbuf + vln->ln.curoff,
+                vln->ln.buff->size - vln->ln.curoff);
+        vln->ln.buff->size--;
+        vln->ln.curoff--;
+        vln_edit_dirty(vln, vln->ln.curoff);
+        return vln_edit_refresh(vln);
+    }
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        delete cursor right character
+* @retval int               0:Success -1:Error    
+*****************************************************************************/
+static int vln_edit_delete(vln_t *vln)
+{
+    if ((vln->ln.curoff < vln->ln.buff->size) && (vln->ln.buff->size > 0)) {
+        VLN_UNDO_RECORD(vln, vln->ln.curoff, 1, NULL, 0);
+
+        memmove(vln->ln.buff->pbuf + vln->ln.curoff,
+                vln->ln.buff->pbuf + vln->ln.curoff + 1,
+                vln->ln.buff->size - vln->ln.curoff - 1);
+        vln->ln.buff->size--;
+        vln_edit_dirty(vln, vln->ln.curoff);
+        return vln_edit_refresh(vln);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        move cursor to left
+* @retval int               0:Success -1:Error    
+*****************************************************************************/
+static int vln_edit_moveleft(vln_t *vln)
+{
+    if (vln->ln.curoff > 0) {
+        vln->ln.curoff--;
+        return vln_edit_refresh(vln);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        move cursor to right
+* @retval int               0:Success -1:Error    
+*****************************************************************************/
+static int vln_edit_moveright(vln_t *vln)
+{
+    if (vln->ln.curoff < vln->ln.buff->size) {
+        vln->ln.curoff++;
+        return vln_edit_refresh(vln);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        move cursor to start of line
+* @retval int               0:Success -1:Error    
+*****************************************************************************/
+static int vln_edit_movehome(vln_t *vln)
+{
+    vln->ln.curoff = 0;
+    return vln_edit_refresh(vln);
+}
+
+/*****************************************************************************
+* @brief        move cursor to end of line
+* @retval int               0:Success -1:Error    
+*****************************************************************************/
+static int vln_edit_moveend(vln_t *vln)
+{
+    vln->ln.curoff = vln->ln.buff->size;
+    return vln_edit_refresh(vln);
+}
+
+/*****************************************************************************
+* @brief        delete the whole line
+* @retval int               0:Success -1:Error    
+*****************************************************************************/
+static int vln_edit_delline(vln_t *vln)
+{
+    VLN_UNDO_RECORD(vln, 0, vln->ln.buff->size, NULL, 0);
+
+    vln->ln.buff->size = 0;
+    vln->ln.curoff = 0;
+    vln_edit_dirty(vln, 0);
+    return vln_edit_refresh(vln);
+}
+
+/*****************************************************************************
+* @brief        delete from cursor to end of line
+* @retval int               0:Success -1:Error    
+*****************************************************************************/
+static int vln_edit_delend(vln_t *vln)
+{
+    VLN_UNDO_RECORD(vln, vln->ln.curoff, vln->ln.buff->size - vln->ln.curoff, NULL, 0);
+
+    vln->ln.buff->size = vln->ln.curoff;
+    vln_edit_dirty(vln, vln->ln.curoff);
+    return vln_edit_refresh(vln);
+}
+
+/*****************************************************************************
+* @brief        delete previosu word
+* @retval int               0:Success -1:Error    
+*****************************************************************************/
+static int vln_edit_delword(vln_t *vln)
+{
+    uint16_t curoff = vln->ln.curoff;
+
+    while ((curoff > 0) && (vln->ln.buff->pbuf[curoff] == ' ')) {
+        curoff--;
+    }
+
+    while ((curoff > 0) && (vln->ln.buff->pbuf[curoff] != ' ')) {
+        curoff--;
+    }
+
+    VLN_UNDO_RECORD(vln, curoff, vln->ln.curoff - curoff, NULL, 0);
+
+    memmove(vln->ln.buff->pbuf + curoff,
+            vln->ln.buff->pbuf + vln->ln.curoff,
+            vln->ln.buff->size - vln->ln.curoff + 1);
+    vln->ln.buff->size -= vln->ln.curoff - curoff;
+    vln->ln.curoff = curoff;
+    vln_edit_dirty(vln, curoff);
+
+    return vln_edit_refresh(vln);
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_edit
+----------------------------------------------------------------------------*/
+
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+
+/** @addtogroup vln_undo
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        forget all records
+*****************************************************************************/
+static void vln_undo_reset(vln_t *vln)
+{
+    vln->undo.top = 0;
+    vln->undo.cur = 0;
+    vln->undo.merge = 0;
+}
+
+/*****************************************************************************
+* @brief        drop oldest records until need bytes are free
+* 
+* @param[in]    vln         
+* @param[in]    need        bytes to append
+* @param[in]    keep        newest bytes that must stay
+* 
+* @retval int               0:Success -1:Arena too small
+*****************************************************************************/
+static int vln_undo_room(vln_t *vln, uint16_t need, uint16_t keep)
+{
+    vln_undo_rec_t rec;
+    uint16_t cut = 0;
+
+    while ((uint32_t)(vln->undo.size - vln->undo.top + cut) < need) {
+        if ((uint32_t)(cut + keep) >= vln->undo.top) {
+            return -1;
+        }
+
+        memcpy(&rec, vln->undo.pbuf + cut, sizeof(rec));
+        cut += VLN_UNDO_OVERHEAD + rec.del + rec.ins;
+    }
+
+    if (cut) {
+        memmove(vln->undo.pbuf, vln->undo.pbuf + cut, vln->undo.top - cut);
+        vln->undo.top -= cut;
+        vln->undo.cur -= cut;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        journal an edit before linebuff changes, a typed character
+*               right after the last one joins its record until a space
+* 
+* @param[in]    vln         
+* @param[in]    off         edit offset
+* @param[in]    del         bytes removed at offset, still in linebuff
+* @param[in]    ins         bytes inserted
+* @param[in]    n           inserted size
+*****************************************************************************/
+static void vln_undo_record(vln_t *vln, uint16_t off, uint16_t del, const char *ins, uint16_t n)
+{
+    vln_undo_rec_t rec;
+    uint16_t size;
+    uint8_t *p;
+
+    if ((NULL == vln->undo.pbuf) || ((0 == del) && (0 == n))) {
+        return;
+    }
+
+    /*!< masked input is not kept anywhere */
+    if (vln->ln.buff->mask) {
+        vln_undo_reset(vln);
+        return;
+    }
+
+    /*!< a new edit drops what was undone */
+    vln->undo.top = vln->undo.cur;
+
+    if (vln->undo.merge && (0 == del) && (1 == n)) {
+        memcpy(&size, vln->undo.pbuf + vln->undo.cur - 2, 2);
+        p = vln->undo.pbuf + vln->undo.cur - size;
+        memcpy(&rec, p, sizeof(rec));
+
+        if (((uint16_t)(rec.off + rec.ins) == off) && (p[sizeof(rec) + rec.ins - 1] != ' ') &&
+            (0 == vln_undo_room(vln, 1, size))) {
+            p = vln->undo.pbuf + vln->undo.cur - size;
+            p[sizeof(rec) + rec.ins] = *ins;
+            rec.ins++;
+            size++;
+            memcpy(p, &rec, sizeof(rec));
+            memcpy(p + size - 2, &size, 2);
+
+            vln->undo.cur++;
+            vln->undo.top = vln->undo.cur;
+            return;
+        }
+    }
+
+    size = VLN_UNDO_OVERHEAD + del + n;
+
+    /*!< older records no longer apply once an edit is missing */
+    if (((uint32_t)VLN_UNDO_OVERHEAD + del + n > UINT16_MAX) || vln_undo_room(vln, size, 0)) {
+        vln_undo_reset(vln);
+        return;
+    }
+
+    rec.off = off;
+    rec.del = del;
+    rec.ins = n;
+
+    p = vln->undo.pbuf + vln->undo.top;
+    memcpy(p, &rec, sizeof(rec));
+    memcpy(p + sizeof(rec), vln->ln.buff->pbuf + off, del);
+    if (n) {
+        /*!< ins is NULL for a pure delete */
+        memcpy(p + sizeof(rec) + del, ins, n);
+    }
+    memcpy(p + size - 2, &size, 2);
+
+    vln->undo.cur += size;
+    vln->undo.top = vln->undo.cur;
+    vln->undo.merge = (0 == del) && (1 == n);
+}
+
+/*****************************************************************************
+* @brief        undo the last applied record or redo the next undone one,
+*               cursor is left after the text put back
+* 
+* @param[in]    vln         
+* @param[in]    redo        
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_undo_apply(vln_t *vln, uint8_t redo)
+{
+    char *pbuf = vln->ln.buff->pbuf;
+    vln_undo_rec_t rec;
+    const uint8_t *p;
+    const uint8_t *text;
+    uint16_t size;
+    uint16_t cut;
+    uint16_t n;
+
+    if (redo ? (vln->undo.cur == vln->undo.top) : (0 == vln->undo.cur)) {
+        return 0;
+    }
+
+    if (redo) {
+        p = vln->undo.pbuf + vln->undo.cur;
+        memcpy(&rec, p, sizeof(rec));
+        vln->undo.cur += VLN_UNDO_OVERHEAD + rec.del + rec.ins;
+
+        cut = rec.del;
+        text = p + sizeof(rec) + rec.del;
+        n = rec.ins;
+    } else {
+        memcpy(&size, vln->undo.pbuf + vln->undo.cur - 2, 2);
+        vln->undo.cur -= size;
+        p = vln->undo.pbuf + vln->undo.cur;
+        memcpy(&rec, p, sizeof(rec));
+
+        cut = rec.ins;
+        text = p + sizeof(rec);
+        n = rec.del;
+    }
+
+    memmove(pbuf + rec.off + n, pbuf + rec.off + cut, vln->ln.buff->size - rec.off - cut);
+    memcpy(pbuf + rec.off, text, n);
+
+    vln->ln.buff->size = vln->ln.buff->size - cut + n;
+    vln->ln.curoff = rec.off + n;
+    vln->undo.merge = 0;
+
+    vln_edit_dirty(vln, rec.off);
+    return vln_edit_refresh(vln);
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_undo
+----------------------------------------------------------------------------*/
+#endif
+
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+
+/** @addtogroup vln_stream
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        take a byte that does not fit the line buffer. the buffer is
+*               handed to the stream callback and starts over, so a line
+*               typed or pasted at its end never loses a byte. from then on
+*               the line is echoed a buffer at a time with one sput and
+*               only takes more bytes, enter or abort
+* 
+* @param[in]    vln         
+* @param[in]    c           byte to append
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_stream_insert(vln_t *vln, char c)
+{
+    size_t idx = 0;
+    uint8_t seq[4];
+
+    if (vln->stm.on) {
+        if (vln->ln.buff->size >= vln->ln.lnmax) {
+            vln_put(vln, vln->ln.buff->pbuf, vln->ln.buff->size, -1);
+            vln->stm.cb(vln->stm.arg, vln->ln.buff->pbuf, vln->ln.buff->size, VLN_STREAM_MORE);
+            vln->ln.buff->size = 0;
+        }
+    } else {
+        /*!< an edit inside the line or a masked line is cut as before */
+        if ((NULL == vln->stm.cb) || vln->ln.buff->mask ||
+            (vln->ln.curoff != vln->ln.buff->size)) {
+            return 0;
+        }
+
+        /*!< the buffer is on screen already, clear what follows it */
+        if (vln_edit_sgr(vln, 0)) {
+            return -1;
+        }
+        if (vln_profile_get(vln)->esc) {
+            vln_edit_erasebelow(vln, seq, &idx, vln->ln.pptoff + vln->ln.buff->size);
+            vln_put(vln, seq, idx, -1);
+        }
+
+        vln->ln.cursor = VLN_OFF_NONE;
+        vln->stm.on = 1;
+        vln->stm.cb(vln->stm.arg, vln->ln.buff->pbuf, vln->ln.buff->size, VLN_STREAM_MORE);
+        vln->ln.buff->size = 0;
+    }
+
+    vln->ln.buff->pbuf[vln->ln.buff->size++] = c;
+    vln->ln.curoff = vln->ln.buff->size;
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        handle a key while the line streams, enter hands over the
+*               rest and returns the line empty, abort tells the callback
+* 
+* @param[in]    vln         
+* @param[in]    c           key after dispatch
+* 
+* @retval int               1:Line complete 0:Continue -1:Error
+*****************************************************************************/
+static int vln_stream_key(vln_t *vln, uint8_t c)
+{
+    switch (c) {
+        case VLN_EXEC_NLN:
+            vln_put(vln, vln->ln.buff->pbuf, vln->ln.buff->size, -1);
+            vln->stm.cb(vln->stm.arg, vln->ln.buff->pbuf, vln->ln.buff->size, VLN_STREAM_END);
+            break;
+
+        case VLN_EXEC_ALN:
+            vln->stm.cb(vln->stm.arg, NULL, 0, VLN_STREAM_ABORT);
+            break;
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+        case VLN_EXEC_PSBG:
+        case VLN_EXEC_PSED:
+            vln->ln.paste = (c == VLN_EXEC_PSBG);
+            return 0;
+#endif
+
+        default:
+            return 0;
+    }
+
+    vln->stm.on = 0;
+    vln->ln.buff->size = 0;
+    vln->ln.curoff = 0;
+    return 1;
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_stream
+----------------------------------------------------------------------------*/
+#endif
+
+/*****************************************************************************
+* @brief        show help
+* @retval int               0:Success -1:Error  
+*****************************************************************************/
+static int vln_help(vln_t *vln)
+{
+    if (sizeof(CFG_VLN_HELP) - 1) {
+        vln_put(vln, CFG_VLN_HELP, sizeof(CFG_VLN_HELP) - 1, -1);
+    }
+    return 0;
+}
+
+/** @addtogroup vln_dispatch
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        dispatch csi sequences
+* 
+* @param[in]    vln         
+* @param[inout] c           character for dispatch
+* @param[in]    expre       extend prefix character
+* @param[in]    pns         params for dispatch
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_dispatch_csi(vln_t *vln, uint8_t *c, uint8_t expre, uint16_t *pns)
+{
+    uint8_t idx;
+
+    if (expre) {
+        if ((expre == '?') && (*c == 'c')) {
+            /*!< device attributes, replied after all detect queries */
+            if (vln->term.type == VLN_TERM_UNKNOWN) {
+                vln->term.type = VLN_TERM_VT100;
+            }
+            vln->term.detect = 0;
+        }
+
+        *c = VLN_EXEC_NUL;
+    } else if (*c == '~') {
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+        if ((pns[0] == 200) || (pns[0] == 201)) {
+            *c = (pns[0] == 200) ? VLN_EXEC_PSBG : VLN_EXEC_PSED;
+            return 0;
+        }
+#endif
+
+        if (pns[0] >= sizeof(vtmap)) {
+            pns[0] = 0;
+        }
+
+        *c = vtmap[pns[0]];
+    } else if (*c == 't') {
+        if (pns[0] == 8) {
+            vln->term.type = VLN_TERM_XTERM;
+            vln_resize(vln, pns[1], pns[2]);
+
+            if (vln->term.nsupt) {
+                vln->term.nsupt = 0;
+                /*!< 1.save cursor                   <esc>7     */
+                /*!< 2.enter alternate screen buffer <esc>[?47h */
+                /*!< 3.clear screen buffer           <esc>[2J   */
+                /*!< 4.move cursor to (1,1)          <esc>[1;1H */
+                /*!< 5.enter normal screen buffer    <esc>[?47l */
+                /*!< 6.restore cursor                <esc>8     */
+                vln_put(vln, "\e7\e[?47h\e[2J\e[1;1H", 18, -1);
+                vln_help(vln);
+                vln_put(vln, "\e[?47l\e8", 8, -1);
+            }
+        }
+
+        *c = VLN_EXEC_NUL;
+    } else if ((*c == 'R') && pns[1] && ((pns[0] > 1) || (pns[1] > 16))) {
+        /*!< cursor position report, not a modified F3 key */
+        if (vln->term.type < VLN_TERM_VT100) {
+            vln->term.type = VLN_TERM_VT100;
+        }
+        vln_resize(vln, pns[0], pns[1]);
+
+        *c = VLN_EXEC_NUL;
+    } else {
+        idx = *c - 0x40;
+        if (idx >= sizeof(xmap)) {
+            idx = 0;
+        }
+
+        *c = xmap[idx];
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        dispatch o sequences
+* 
+* @param[in]    vln         
+* @param[inout] c           character for dispatch
+* @param[in]    pns         params for dispatch     
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_dispatch_o(vln_t *vln, uint8_t *c, uint16_t *pns)
+{
+    (void)vln;
+    (void)pns;
+    *c = VLN_EXEC_NUL;
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        dispatch alt sequences
+* 
+* @param[in]    vln         
+* @param[inout] c           character for dispatch
+* @param[in]    pns         params for dispatch     
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_dispatch_alt(vln_t *vln, uint8_t *c, uint16_t *pns)
+{
+    (void)vln;
+    (void)pns;
+    *c = VLN_EXEC_NUL;
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        dispatch ctrl sequences
+* 
+* @param[in]    vln         
+* @param[inout] c           character for dispatch
+* @param[in]    pns         params for dispatch     
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_dispatch_ctrl(vln_t *vln, uint8_t *c, uint16_t *pns)
+{
+    (void)vln;
+    (void)c;
+    (void)pns;
+
+    *c = c0map[*c];
+
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_dispatch
+----------------------------------------------------------------------------*/
+
+#if defined(CFG_VLN_FRAME) && CFG_VLN_FRAME
+
+/** @addtogroup vln_frame
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        CRC-16/CCITT-FALSE, a nibble at a time
+*****************************************************************************/
+static uint16_t vln_frame_crc(const uint8_t *data, uint16_t len)
+{
+    static const uint16_t nibble[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+        0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+    };
+    uint16_t crc = 0xffff;
+
+    while (len--) {
+        crc = (crc << 4) ^ nibble[(crc >> 12) ^ (*data >> 4)];
+        crc = (crc << 4) ^ nibble[(crc >> 12) ^ (*data++ & 0x0f)];
+    }
+
+    return crc;
+}
+
+/*****************************************************************************
+* @brief        send a frame, its payload already in place after the header
+* 
+* @param[in]    vln         
+* @param[in]    type        VLN_FRAME_RESPONSE or VLN_FRAME_ERROR
+* @param[in]    tag         tag of the request
+* @param[in]    len         payload size
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_frame_send(vln_t *vln, uint8_t type, uint8_t tag, uint16_t len)
+{
+    uint8_t *p = vln->frm.pbuf;
+    uint16_t crc;
+
+    p[0] = VLN_C0_ESC;
+    p[1] = '_';
+    p[2] = 'V';
+    p[3] = type;
+    p[4] = tag;
+    p[5] = (uint8_t)(len >> 8);
+    p[6] = (uint8_t)len;
+
+    crc = vln_frame_crc(p + VLN_FRAME_INTRO, VLN_FRAME_HEAD + len);
+
+    p += VLN_FRAME_INTRO + VLN_FRAME_HEAD + len;
+    p[0] = (uint8_t)(crc >> 8);
+    p[1] = (uint8_t)crc;
+    p[2] = VLN_C0_ESC;
+    p[3] = '\\';
+
+    vln_put(vln, vln->frm.pbuf, VLN_FRAME_OVERHEAD + len, -1);
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        answer with an error code, tagged if the tag arrived
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_frame_error(vln_t *vln, uint8_t code)
+{
+    uint8_t tag = (vln->frm.len > 1) ? vln->frm.pbuf[VLN_FRAME_INTRO + 1] : 0;
+
+    vln->frm.pbuf[VLN_FRAME_INTRO + VLN_FRAME_HEAD] = code;
+    return vln_frame_send(vln, VLN_FRAME_ERROR, tag, 1);
+}
+
+/*****************************************************************************
+* @brief        resync after a terminator not where the length says. if an
+*               ESC \ went by as payload, the frame lost bytes and input is
+*               keys again from there, the keys already taken are gone but
+*               an intro of the next frame is kept. otherwise bytes were
+*               added, or the next frame is cut too, and input is dropped
+*               up to the next ESC \ or ESC _
+* 
+* @param[in]    vln         
+* @param[in]    head        frame bytes after the intro
+* @param[in]    need        frame bytes taken
+*****************************************************************************/
+static void vln_frame_resync(vln_t *vln, const uint8_t *head, uint32_t need)
+{
+    uint8_t state = VLN_SEQ_FRAME;
+    uint32_t i;
+
+    for (i = VLN_FRAME_HEAD; (i + 1) < need; i++) {
+        if ((VLN_C0_ESC == head[i]) && ('\\' == head[i + 1])) {
+            state = VLN_SEQ_NONE;
+            break;
+        }
+    }
+
+    for (i += 2; (VLN_SEQ_FRAME != state) && (i < need); i++) {
+        if (VLN_C0_ESC == head[i]) {
+            state = VLN_SEQ_ESC;
+        } else if ((VLN_SEQ_ESC == state) && ('_' == head[i])) {
+            state = VLN_SEQ_APC;
+        } else if ((VLN_SEQ_APC == state) && ('V' == head[i])) {
+            state = VLN_SEQ_FRAME;
+        } else {
+            state = VLN_SEQ_NONE;
+        }
+    }
+
+    vln->seq.state = state;
+
+    if (VLN_SEQ_FRAME == state) {
+        vln->frm.skip = 1;
+        vln->frm.last = head[need - 1];
+    }
+}
+
+/*****************************************************************************
+* @brief        take one byte after ESC _ V, answer once the frame is
+*               complete and give input back to the line. nothing is echoed
+*               and the line is not touched. a length over the buffer is
+*               answered as soon as the header is in and input is then
+*               dropped up to the next ESC \ or ESC _, so a bad length
+*               never swallows what is typed after the frame
+* 
+* @param[in]    vln         
+* @param[in]    c           input byte
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_frame_byte(vln_t *vln, uint8_t c)
+{
+    uint8_t *head = vln->frm.pbuf + VLN_FRAME_INTRO;
+    uint16_t cap = vln->frm.size - VLN_FRAME_OVERHEAD;
+    uint32_t at = vln->frm.len++;
+    uint16_t len;
+    uint8_t *tail;
+
+    if (vln->frm.skip) {
+        /*!< the next frame may follow right behind the broken one */
+        if ((VLN_C0_ESC == vln->frm.last) && ('\\' == c)) {
+            vln->seq.state = VLN_SEQ_NONE;
+        } else if ((VLN_C0_ESC == vln->frm.last) && ('_' == c)) {
+            vln->seq.state = VLN_SEQ_APC;
+        }
+        vln->frm.last = c;
+        return 0;
+    }
+
+    /*!< need never passes the buffer, so every byte fits */
+    head[at] = c;
+
+    if (at == (VLN_FRAME_HEAD - 1)) {
+        len = (head[2] << 8) | head[3];
+
+        if (len > cap) {
+            /*!< a bad length must not swallow what is typed after it */
+            vln->frm.skip = 1;
+            vln->frm.last = c;
+            return vln_frame_error(vln, VLN_FRAME_ESIZE);
+        }
+
+        vln->frm.need = VLN_FRAME_HEAD + len + VLN_FRAME_TAIL;
+    }
+
+    if ((0 == vln->frm.need) || (vln->frm.len < vln->frm.need)) {
+        return 0;
+    }
+
+    vln->seq.state = VLN_SEQ_NONE;
+    len = (uint16_t)(vln->frm.need - VLN_FRAME_HEAD - VLN_FRAME_TAIL);
+    tail = head + VLN_FRAME_HEAD + len;
+
+    if ((VLN_C0_ESC != tail[2]) || ('\\' != tail[3])) {
+        /*!< bytes lost or added */
+        vln_frame_resync(vln, head, vln->frm.need);
+        return vln_frame_error(vln, VLN_FRAME_ECRC);
+    }
+
+    if (vln_frame_crc(head, VLN_FRAME_HEAD + len) != ((tail[0] << 8) | tail[1])) {
+        return vln_frame_error(vln, VLN_FRAME_ECRC);
+    }
+
+    if (VLN_FRAME_REQUEST != head[0]) {
+        return vln_frame_error(vln, VLN_FRAME_ETYPE);
+    }
+
+    len = vln->frm.cb(vln->frm.arg, head + VLN_FRAME_HEAD, len, cap);
+
+    return vln_frame_send(vln, VLN_FRAME_RESPONSE, head[1], (len > cap) ? cap : len);
+}
+
+/*****************************************************************************
+* @brief        drop a frame that stalled, the host learns input is back to
+*               keys unless a broken frame was already answered
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_frame_expire(vln_t *vln)
+{
+    return vln->frm.skip ? 0 : vln_frame_error(vln, VLN_FRAME_ETIME);
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_frame
+----------------------------------------------------------------------------*/
+#endif
+
+/** @addtogroup vln_seq_execute
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        parse one byte of csi sequences
+* 
+* @param[in]    vln         
+* @param[in]    c           input byte
+* 
+* @retval int               1:Final byte 0:Pending -1:Invalid byte
+*****************************************************************************/
+static int vln_seqexec_pcsi(vln_t *vln, uint8_t c)
+{
+    if (('0' <= c) && (c <= '9')) {
+        if (vln->seq.npn < VLN_PNS_MAX) {
+            vln->seq.pns[vln->seq.npn] = vln->seq.pns[vln->seq.npn] * 10 + (c - '0');
+        }
+    } else if (c == ';') {
+        if (vln->seq.npn < VLN_PNS_MAX) {
+            vln->seq.npn++;
+        }
+    } else if (('<' <= c) && (c <= '?')) {
+        /*!< private parameter prefix */
+        vln->seq.expre = c;
+    } else if ((0x40 <= c) && (c <= 0x7e)) {
+        return 1;
+    } else if ((c < 0x20) || (c > 0x2f)) {
+        /*!< intermediate bytes are ignored */
+        return -1;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        execute CSI sequences
+* 
+* @param[in]    vln         
+* @param[inout] c           input byte, character for dispatch
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_seqexec_csi(vln_t *vln, uint8_t *c)
+{
+    int ret = vln_seqexec_pcsi(vln, *c);
+
+    if (ret <= 0) {
+        /*!< pending, or malformed sequence is dropped */
+        if (ret < 0) {
+            vln->seq.state = VLN_SEQ_NONE;
+        }
+        *c = VLN_EXEC_NUL;
+        return 0;
+    }
+
+    vln->seq.state = VLN_SEQ_NONE;
+    return vln_dispatch_csi(vln, c, vln->seq.expre, vln->seq.pns);
+}
+
+/*****************************************************************************
+* @brief        execute ALT sequences
+* 
+* @param[in]    vln         
+* @param[inout] c           character for dispatch
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_seqexec_alt(vln_t *vln, uint8_t *c)
+{
+    vln->seq.state = VLN_SEQ_NONE;
+    return vln_dispatch_alt(vln, c, vln->seq.pns);
+}
+
+/*****************************************************************************
+* @brief        execute O sequences
+* 
+* @param[in]    vln         
+* @param[inout] c           character for dispatch
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_seqexec_o(vln_t *vln, uint8_t *c)
+{
+    vln->seq.state = VLN_SEQ_NONE;
+    return vln_dispatch_o(vln, c, vln->seq.pns);
+}
+
+/*****************************************************************************
+* @brief        ms a partial sequence may stall before it is resolved, a
+*               frame may take longer than a key
+*****************************************************************************/
+static uint32_t vln_seqtimeout(vln_t *vln)
+{
+#if defined(CFG_VLN_FRAME) && CFG_VLN_FRAME
+    if (VLN_SEQ_FRAME == vln->seq.state) {
+        return CFG_VLN_FRAME_TIMEOUT;
+    }
+#else
+    (void)vln;
+#endif
+
+    return CFG_VLN_ESC_TIMEOUT;
+}
+
+/*****************************************************************************
+* @brief        execute sequences one byte at a time, the parser state lives
+*               in vln so input can stop anywhere inside a sequence
+* 
+* @param[in]    vln         
+* @param[inout] c           input byte, character for dispatch or
+*                           VLN_EXEC_NUL while sequence is pending
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_seqexec(vln_t *vln, uint8_t *c)
+{
+    /*!< inter-byte timeout runs from the latest sequence byte */
+    if (NULL != vln->tick) {
+        vln->seq.tick = vln->tick();
+    }
+
+    switch (vln->seq.state) {
+        case VLN_SEQ_NONE:
+            vln->seq.state = VLN_SEQ_ESC;
+            break;
+
+        case VLN_SEQ_ESC:
+            if (*c == 'O') {
+                vln->seq.state = VLN_SEQ_SS3;
+            } else if (*c == '[') {
+                vln->seq.state = VLN_SEQ_CSI;
+                vln->seq.expre = 0;
+                vln->seq.npn = 0;
+                memset(vln->seq.pns, 0, sizeof(vln->seq.pns));
+#if defined(CFG_VLN_FRAME) && CFG_VLN_FRAME
+            } else if ((*c == '_') && (NULL != vln->frm.cb)) {
+                vln->seq.state = VLN_SEQ_APC;
+#endif
+            } else {
+                return vln_seqexec_alt(vln, c);
+            }
+            break;
+
+        case VLN_SEQ_SS3:
+            return vln_seqexec_o(vln, c);
+
+        case VLN_SEQ_CSI:
+            return vln_seqexec_csi(vln, c);
+
+#if defined(CFG_VLN_FRAME) && CFG_VLN_FRAME
+        case VLN_SEQ_APC:
+            /*!< other application strings are not for vln, dropped up
+                 to their ESC \ like the rest of a broken frame */
+            vln->seq.state = VLN_SEQ_FRAME;
+            vln->frm.len = 0;
+            vln->frm.need = 0;
+            vln->frm.skip = (*c != 'V');
+            vln->frm.last = *c;
+            break;
+
+        case VLN_SEQ_FRAME:
+            if (vln_frame_byte(vln, *c)) {
+                return -1;
+            }
+            break;
+#endif
+
+        default:
+            vln->seq.state = VLN_SEQ_NONE;
+            break;
+    }
+
+    *c = VLN_EXEC_NUL;
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_seq_execute
+----------------------------------------------------------------------------*/
+
+#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
+
+/** @addtogroup vln_history
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        reverse memcpy 4byte align
+* 
+* @param[in]    dst         
+* @param[in]    src         
+* @param[in]    n           byte
+* 
+*****************************************************************************/
+static void vln_rvsememcpy4(void *dst, const void *src, size_t n)
+{
+    uint32_t *pout = dst;
+    uint32_t *pin = (uint32_t *)src - 1;
+
+    for (; n > 0; n -= 4) {
+        *pout++ = *pin--;
+    }
+}
+
+/*****************************************************************************
+* @brief        align 4 up
+* 
+* @param[in]    size        size
+* 
+* @retval                   align size
+*****************************************************************************/
+static uint32_t vln_align4(uint32_t size)
+{
+    if (size & 0x3) {
+        return (size & ~0x3) + 4;
+    } else {
+        return size;
+    }
+}
+
+/*****************************************************************************
+* @brief        cache linbuff to history list
+* 
+* @param[in]    vln         
+* 
+*****************************************************************************/
+static void vln_history_cache(vln_t *vln)
+{
+    uint16_t unused;
+    uint16_t offset;
+    uint16_t remain;
+    uint16_t lnsize;
+    uint8_t *dst;
+
+    /*!< fifo unused size */
+    unused = vln->hist.size - (vln->hist.cache - vln->hist.out);
+
+    /*!< line and size total size, alignup 4 */
+    lnsize = vln_align4(vln->ln.buff->size + 4);
+
+    /*!< free the oldest history */
+    if (lnsize > unused) {
+        vln->hist.out += lnsize - unused;
+    }
+
+    /*!< fifo write offset */
+    offset = vln->hist.cache & vln->hist.mask;
+
+    /*!< unused size before ringloop */
+    remain = vln->hist.size - offset;
+    remain = remain > lnsize ? lnsize : remain;
+
+    dst = (uint8_t *)(vln->ln.buff) + lnsize;
+
+    vln_rvsememcpy4(vln->hist.pbuf + offset, dst, remain);
+    vln_rvsememcpy4(vln->hist.pbuf, dst - remain, lnsize - remain);
+
+    vln->hist.in = vln->hist.cache + lnsize;
+
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+    if (NULL != vln->sug.pidx) {
+        vln_suggest_evict(vln);
+    }
+#endif
+}
+
+/*****************************************************************************
+* @brief        store linebuff to history list
+* 
+* @param[in]    vln         
+*                
+*****************************************************************************/
+static void vln_history_store(vln_t *vln)
+{
+    VLN_PROBE_BEGIN(vln, store);
+
+#if defined(CFG_VLN_SHARE) && CFG_VLN_SHARE
+    if ((vln->ln.buff->size > 0) && (NULL != vln->hist.share)) {
+        vln_share_append(vln->hist.share, vln->ln.buff->pbuf, vln->ln.buff->size);
+    }
+#endif
+
+    if ((vln->ln.buff->size > 0) && (NULL != vln->hist.pbuf)) {
+        vln_history_cache(vln);
+
+        /*!< update cache index */
+        vln->hist.cache = vln->hist.in;
+
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+        if (NULL != vln->sug.pidx) {
+            vln_suggest_add(vln);
+        }
+#endif
+    }
+
+    VLN_PROBE_END(vln, store, VLN_PROBE_HSTORE);
+}
+
+/*****************************************************************************
+* @brief        load special index history to linebuff
+* 
+* @param[in]    vln         
+* @param[in]    index       history index
+* 
+* @retval                   0:Success -1:Error
+*****************************************************************************/
+static int vln_history_load(vln_t *vln, uint16_t index)
+{
+    uint16_t used;
+    uint16_t offset;
+    uint16_t remain;
+    uint16_t lnsize;
+    uint16_t histin;
+    uint16_t count;
+    uint16_t prevused;
+
+    /*!< history disabled for this instance */
+    if (NULL == vln->hist.pbuf) {
+        return 0;
+    }
+
+    if (vln->hist.index == 0) {
+        vln_history_cache(vln);
+    }
+
+    lnsize = 0;
+    count = index;
+    histin = vln->hist.in;
+    prevused = vln->hist.in - vln->hist.out;
+
+    do {
+        histin -= lnsize;
+
+        /*!< fifo used size */
+        used = histin - vln->hist.out;
+
+        if ((used == 0) || (used > prevused)) {
+            return 0;
+        }
+
+        prevused = used;
+
+        /*!< fifo read offset */
+        offset = (histin - 4) & vln->hist.mask;
+
+        /*!< read fisrt 4byte and alignup 4 */
+        lnsize = vln_align4(((uint32_t *)(vln->hist.pbuf + offset))[0] + 4);
+
+        if (lnsize > used) {
+            return 0;
+        }
+
+    } while (count--);
+
+    offset = (histin - lnsize) & vln->hist.mask;
+
+    /*!< unused size before ringloop */
+    remain = vln->hist.size - offset;
+    remain = remain > lnsize ? lnsize : remain;
+
+    /*!< temp value */
+    lnsize = lnsize - remain;
+
+    vln_rvsememcpy4((uint8_t *)(vln->ln.buff) + lnsize,
+                    vln->hist.pbuf + offset + remain, remain);
+
+    vln_rvsememcpy4(vln->ln.buff, vln->hist.pbuf + lnsize, lnsize);
+
+    vln->ln.curoff = vln->ln.buff->size;
+    vln->hist.index = index;
+    vln_edit_dirty(vln, 0);
+
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+    /*!< a recalled line starts a new journal */
+    vln_undo_reset(vln);
+#endif
+    return vln_edit_refresh(vln);
+}
+
+/*****************************************************************************
+* @brief        check lines are stored anywhere, private ring or shared log
+*****************************************************************************/
+__unused static uint8_t vln_history_enabled(vln_t *vln)
+{
+#if defined(CFG_VLN_SHARE) && CFG_VLN_SHARE
+    if (NULL != vln->hist.share) {
+        return 1;
+    }
+#endif
+
+    return NULL != vln->hist.pbuf;
+}
+
+#if defined(CFG_VLN_SHARE) && CFG_VLN_SHARE
+/*****************************************************************************
+* @brief        load the next line of the shared log towards older or newer
+*               lines. lines other sessions are still appending are skipped,
+*               the walk ends at lines the log no longer holds, and past the
+*               newest it comes back to the line being edited, which is kept
+*               in the private ring if there is one
+* 
+* @param[in]    vln         
+* @param[in]    dir         -1 for older, 1 for newer
+*
+* @retval                   0:Success -1:Error
+*****************************************************************************/
+static int vln_history_loadshare(vln_t *vln, int32_t dir)
+{
+    struct vln_share *share = vln->hist.share;
+    uint32_t next = vln_share_next(share);
+    uint32_t seq;
+    uint16_t len;
+    int ret;
+
+    if (vln->hist.index == 0) {
+        if (dir > 0) {
+            return 0;
+        }
+
+        if (NULL != vln->hist.pbuf) {
+            vln_history_cache(vln);
+        }
+        vln->hist.seq = next;
+    }
+
+    for (seq = vln->hist.seq + dir; seq != next; seq += dir) {
+        ret = vln_share_read(share, seq, NULL, 0, &len);
+        if (ret == 0) {
+            break;
+        }
+
+        if ((ret < 0) && (dir < 0)) {
+            return 0;
+        }
+    }
+
+    if (seq == next) {
+        if (NULL != vln->hist.pbuf) {
+            return vln_history_load(vln, 0);
+        }
+
+        vln->ln.buff->size = 0;
+        vln->hist.index = 0;
+    } else {
+        /*!< overwritten while copied, the cut line is dropped */
+        ret = vln_share_read(share, seq, vln->ln.buff->pbuf, vln->ln.lnmax, &len);
+        vln->ln.buff->size = (ret == 0) ? len : 0;
+        vln->hist.index = 1;
+        vln->hist.seq = seq;
+    }
+
+    vln->ln.curoff = vln->ln.buff->size;
+    vln_edit_dirty(vln, 0);
+
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+    vln_undo_reset(vln);
+#endif
+    return vln_edit_refresh(vln);
+}
+#endif
+
+/*****************************************************************************
+* @brief        load prev history to linebuff
+* 
+* @param[in]    vln         
+*
+* @retval                   0:Success -1:Error
+*****************************************************************************/
+static int vln_history_loadprev(vln_t *vln)
+{
+    uint16_t lnhist = vln->hist.index + 1;
+    int ret;
+
+    VLN_PROBE_BEGIN(vln, load);
+#if defined(CFG_VLN_SHARE) && CFG_VLN_SHARE
+    if (NULL != vln->hist.share) {
+        ret = vln_history_loadshare(vln, -1);
+    } else
+#endif
+    {
+        ret = vln_history_load(vln, lnhist);
+    }
+    VLN_PROBE_END(vln, load, VLN_PROBE_HLOAD);
+
+    return ret;
+}
+
+/*****************************************************************************
+* @brief        load next history to linebuff
+* 
+* @param[in]    vln         
+*
+* @retval                   0:Success -1:Error
+*****************************************************************************/
+static int vln_history_loadnext(vln_t *vln)
+{
+    uint16_t lnhist = vln->hist.index > 0 ? vln->hist.index - 1 : 0;
+    int ret;
+
+    VLN_PROBE_BEGIN(vln, load);
+#if defined(CFG_VLN_SHARE) && CFG_VLN_SHARE
+    if (NULL != vln->hist.share) {
+        ret = vln_history_loadshare(vln, 1);
+    } else
+#endif
+    {
+        ret = vln_history_load(vln, lnhist);
+    }
+    VLN_PROBE_END(vln, load, VLN_PROBE_HLOAD);
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_history
+----------------------------------------------------------------------------*/
+#endif
+
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+
+/** @addtogroup vln_suggest
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        character of history entry, entries are stored word reversed
+* 
+* @param[in]    vln         
+* @param[in]    rec         index record of entry
+* @param[in]    i           character offset
+*****************************************************************************/
+static char vln_suggest_char(vln_t *vln, const vln_histidx_t *rec, uint16_t i)
+{
+    return vln->hist.pbuf[(uint16_t)(rec->end - 4 * ((i >> 2) + 2) + (i & 3)) & vln->hist.mask];
+}
+
+/*****************************************************************************
+* @brief        compare history entry with string from offset, shorter of
+*               the two sizes
+* 
+* @param[in]    vln         
+* @param[in]    rec         index record of entry
+* @param[in]    str         string
+* @param[in]    len         string size
+* @param[in]    from        offset both are known to agree up to
+* 
+* @retval int               <0:entry before 0:same bytes >0:entry after
+*****************************************************************************/
+static int vln_suggest_cmp(vln_t *vln, const vln_histidx_t *rec, const char *str, uint16_t len,
+                           uint16_t from)
+{
+    uint16_t end = (rec->size < len) ? rec->size : len;
+    uint8_t c;
+
+    for (; from < end; from++) {
+        c = vln_suggest_char(vln, rec, from);
+        if (c != (uint8_t)str[from]) {
+            return (c < (uint8_t)str[from]) ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        first sorted position in [lo, hi) whose entry sorts after
+*               string, or only after entries starting with it
+* 
+* @param[in]    vln         
+* @param[in]    lo          range start
+* @param[in]    hi          range end
+* @param[in]    str         string
+* @param[in]    len         string size
+* @param[in]    from        offset entries in range agree with string up to
+* @param[in]    ext         1:entries starting with string sort after it
+*                           0:entries starting with string are skipped
+* 
+* @retval uint16_t          sorted position
+*****************************************************************************/
+static uint16_t vln_suggest_bound(vln_t *vln, uint16_t lo, uint16_t hi, const char *str,
+                                  uint16_t len, uint16_t from, uint8_t ext)
+{
+    const vln_histidx_t *rec;
+    uint16_t mid;
+    int ret;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        rec = &vln->sug.pidx[vln->sug.pidx[mid].sort];
+        ret = vln_suggest_cmp(vln, rec, str, len, from);
+
+        if ((ret > 0) || (ext && (ret == 0) && (rec->size > len))) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    return lo;
+}
+
+/*****************************************************************************
+* @brief        newer of two index slots, VLN_OFF_NONE is older than any
+*****************************************************************************/
+static uint16_t vln_suggest_newer(vln_t *vln, uint16_t a, uint16_t b)
+{
+    if ((VLN_OFF_NONE == a) || ((VLN_OFF_NONE != b) && (((uint16_t)(b - vln->sug.out) & vln->sug.mask) >
+                                                        ((uint16_t)(a - vln->sug.out) & vln->sug.mask)))) {
+        return b;
+    }
+
+    return a;
+}
+
+/*****************************************************************************
+* @brief        newest slot under tree node, leaves are sorted positions
+*****************************************************************************/
+static uint16_t vln_suggest_node(vln_t *vln, uint32_t node)
+{
+    uint32_t n = (uint32_t)vln->sug.mask + 1;
+
+    if (node < n) {
+        return vln->sug.pidx[node].best;
+    }
+
+    node -= n;
+    return (node < (uint16_t)(vln->sug.in - vln->sug.out)) ? vln->sug.pidx[node].sort : VLN_OFF_NONE;
+}
+
+/*****************************************************************************
+* @brief        rebuild the newest-entry tree over sorted positions, and
+*               forget the range of the last lookup, positions have moved
+*****************************************************************************/
+static void vln_suggest_build(vln_t *vln)
+{
+    uint32_t node;
+
+    for (node = vln->sug.mask; node > 0; node--) {
+        vln->sug.pidx[node].best =
+            vln_suggest_newer(vln, vln_suggest_node(vln, 2 * node), vln_suggest_node(vln, 2 * node + 1));
+    }
+
+    vln->sug.len = 0;
+}
+
+/*****************************************************************************
+* @brief        newest entry at sorted positions [lo, hi)
+* 
+* @retval uint16_t          index of entry, VLN_OFF_NONE if range is empty
+*****************************************************************************/
+static uint16_t vln_suggest_newest(vln_t *vln, uint32_t lo, uint32_t hi)
+{
+    uint32_t n = (uint32_t)vln->sug.mask + 1;
+    uint16_t best = VLN_OFF_NONE;
+
+    for (lo += n, hi += n; lo < hi; lo >>= 1, hi >>= 1) {
+        if (lo & 1) {
+            best = vln_suggest_newer(vln, best, vln_suggest_node(vln, lo++));
+        }
+        if (hi & 1) {
+            best = vln_suggest_newer(vln, best, vln_suggest_node(vln, --hi));
+        }
+    }
+
+    if (VLN_OFF_NONE == best) {
+        return VLN_OFF_NONE;
+    }
+
+    /*!< slot to index */
+    return vln->sug.out + ((uint16_t)(best - vln->sug.out) & vln->sug.mask);
+}
+
+/*****************************************************************************
+* @brief        drop oldest index record from sorted positions
+*****************************************************************************/
+static void vln_suggest_drop(vln_t *vln)
+{
+    uint16_t count = vln->sug.in - vln->sug.out;
+    uint16_t slot = vln->sug.out & vln->sug.mask;
+    uint16_t pos;
+
+    for (pos = 0; vln->sug.pidx[pos].sort != slot; pos++) {
+    }
+
+    for (; (uint16_t)(pos + 1) < count; pos++) {
+        vln->sug.pidx[pos].sort = vln->sug.pidx[pos + 1].sort;
+    }
+
+    vln->sug.out++;
+}
+
+/*****************************************************************************
+* @brief        drop index records of evicted history entries
+*****************************************************************************/
+static void vln_suggest_evict(vln_t *vln)
+{
+    vln_histidx_t *rec;
+    uint16_t start;
+    uint16_t out = vln->sug.out;
+
+    while (vln->sug.in != vln->sug.out) {
+        rec = &vln->sug.pidx[vln->sug.out & vln->sug.mask];
+        start = rec->end - vln_align4(rec->size + 4);
+
+        if ((uint16_t)(start - vln->hist.out) <= (uint16_t)(vln->hist.cache - vln->hist.out)) {
+            break;
+        }
+
+        vln_suggest_drop(vln);
+    }
+
+    if (out != vln->sug.out) {
+        vln_suggest_build(vln);
+    }
+}
+
+/*****************************************************************************
+* @brief        add stored linebuff to prefix index, sorted after equal
+*               entries so the newest of them comes last
+*****************************************************************************/
+static void vln_suggest_add(vln_t *vln)
+{
+    vln_histidx_t *rec;
+    uint16_t slot;
+    uint16_t pos;
+    uint16_t count;
+
+    /*!< index full, drop the oldest */
+    if ((uint16_t)(vln->sug.in - vln->sug.out) > vln->sug.mask) {
+        vln_suggest_drop(vln);
+    }
+
+    slot = vln->sug.in & vln->sug.mask;
+    rec = &vln->sug.pidx[slot];
+    rec->end = vln->hist.cache;
+    rec->size = vln->ln.buff->size;
+
+    count = vln->sug.in - vln->sug.out;
+    pos = vln_suggest_bound(vln, 0, count, vln->ln.buff->pbuf, rec->size, 0, 1);
+
+    for (; count > pos; count--) {
+        vln->sug.pidx[count].sort = vln->sug.pidx[count - 1].sort;
+    }
+
+    vln->sug.pidx[pos].sort = slot;
+    vln->sug.in++;
+
+    vln_suggest_build(vln);
+}
+
+/*****************************************************************************
+* @brief        find the most recent entry longer than and starting with
+*               linebuff, the entries extending it are a run of sorted
+*               positions found by binary search, the newest of them comes
+*               from the tree
+* 
+* @param[in]    vln         
+* @param[in]    from        linebuff only grew past this size since the last
+*                           lookup, search stays in its range, 0 for all
+* 
+* @retval uint16_t          index of entry, VLN_OFF_NONE if not found
+*****************************************************************************/
+static uint16_t vln_suggest_find(vln_t *vln, uint16_t from)
+{
+    const char *pbuf = vln->ln.buff->pbuf;
+    uint16_t size = vln->ln.buff->size;
+    uint16_t lo = vln->sug.lo;
+    uint16_t hi = vln->sug.hi;
+
+    if (0 == from) {
+        lo = 0;
+        hi = vln->sug.in - vln->sug.out;
+    }
+
+    lo = vln_suggest_bound(vln, lo, hi, pbuf, size, from, 1);
+    hi = vln_suggest_bound(vln, lo, hi, pbuf, size, from, 0);
+
+    vln->sug.lo = lo;
+    vln->sug.hi = hi;
+
+    return vln_suggest_newest(vln, lo, hi);
+}
+
+/*****************************************************************************
+* @brief        update suggestion after edit and decide what to show
+* 
+* @param[in]    vln         
+* @param[in]    dirty       first changed offset of this refresh
+* @param[in]    vis         visible size of line
+* @param[out]   show        suggestion characters to show
+* 
+* @retval uint8_t           1:screen need redraw 0:screen is up to date
+*****************************************************************************/
+static uint8_t vln_suggest_update(vln_t *vln, uint16_t dirty, uint16_t vis, uint16_t *show)
+{
+    const vln_histidx_t *rec;
+    uint16_t size = vln->ln.buff->size;
+    uint16_t end = vln->ln.pptoff + vis;
+    uint16_t avail;
+    uint16_t hit = vln->sug.hit;
+
+    *show = 0;
+
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+    /*!< suggestion stays on the row of line end */
+    if (vln->ln.wrap) {
+        end %= vln->term.col;
+    }
+#endif
+
+    if (NULL == vln->sug.pidx) {
+        return 0;
+    }
+
+    /*!< evicted */
+    if ((uint16_t)(hit - vln->sug.out) >= (uint16_t)(vln->sug.in - vln->sug.out)) {
+        hit = VLN_OFF_NONE;
+    }
+
+    if (dirty != VLN_OFF_NONE) {
+        if (size == 0) {
+            hit = VLN_OFF_NONE;
+        } else if ((dirty >= vln->sug.len) && (size > vln->sug.len) && (vln->sug.len > 0)) {
+            /*!< prefix extended, matches are inside the last range */
+            hit = vln_suggest_find(vln, vln->sug.len);
+        } else {
+            hit = vln_suggest_find(vln, 0);
+        }
+
+        vln->sug.hit = hit;
+        vln->sug.len = size;
+    }
+
+    /*!< shown dim, which takes xterm colours */
+    if ((hit != VLN_OFF_NONE) && (vln->ln.curoff == size) && vln_profile_get(vln)->ext &&
+        !vln->ln.buff->mask && (vln->hist.index == 0)) {
+        rec = &vln->sug.pidx[hit & vln->sug.mask];
+        *show = rec->size - size;
+
+        /*!< keep the last column and right segment free */
+        avail = vln->term.col - end;
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+        if (vln_prompt_rfits(vln, end)) {
+            avail -= vln->ppt.rptoff;
+        }
+#endif
+        avail = avail ? avail - 1 : 0;
+
+        if (*show > avail) {
+            *show = avail;
+        }
+    }
+
+    if ((*show == 0) && (vln->sug.shown == 0)) {
+        return 0;
+    }
+
+    /*!< typed characters overwrote the head of the same suggestion */
+    if ((hit == vln->sug.drawn) && (size >= vln->sug.from) &&
+        ((size + *show) == (vln->sug.from + vln->sug.shown))) {
+        vln->sug.from = size;
+        vln->sug.shown = *show;
+        return 0;
+    }
+
+    return 1;
+}
+
+/*****************************************************************************
+* @brief        output suggestion after line end
+* 
+* @param[in]    vln         
+* @param[in]    vis         visible size of line
+* @param[in]    show        suggestion characters to show
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_suggest_draw(vln_t *vln, uint16_t vis, uint16_t show)
+{
+    const vln_histidx_t *rec = &vln->sug.pidx[vln->sug.hit & vln->sug.mask];
+    uint16_t size = vln->ln.buff->size;
+    vln_sgr_t sgr = { .raw = 0 };
+    uint16_t i;
+    uint8_t colors;
+    uint8_t n;
+    char chunk[16];
+
+    vln->sug.drawn = vln->sug.hit;
+    vln->sug.from = size;
+    vln->sug.shown = show;
+
+    if (show == 0) {
+        return 0;
+    }
+
+    if (vln_edit_cursor(vln, vln->ln.pptoff + vis)) {
+        return -1;
+    }
+
+    /*!< bright black, which 8 colours would show as white, so dim there */
+    colors = vln->sgr.colors ? vln->sgr.colors : vln_profile_get(vln)->colors;
+    if (colors >= VLN_COLORS_256) {
+        sgr.foreground = VLN_SGR_INDEX(8);
+    } else {
+        sgr.dim = 1;
+    }
+
+    if (vln_edit_sgr(vln, sgr.raw)) {
+        return -1;
+    }
+
+    for (i = 0; i < show; i += n) {
+        for (n = 0; (n < sizeof(chunk)) && ((i + n) < show); n++) {
+            chunk[n] = vln_suggest_char(vln, rec, size + i + n);
+        }
+        vln_put(vln, chunk, n, -1);
+    }
+
+    if (vln_edit_sgr(vln, 0)) {
+        return -1;
+    }
+
+    vln->ln.cursor += show;
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        accept suggestion into linebuff
+* 
+* @param[in]    vln         
+* 
+* @retval int               1:Accepted 0:No suggestion
+*****************************************************************************/
+static int vln_suggest_accept(vln_t *vln)
+{
+    const vln_histidx_t *rec;
+    uint16_t size = vln->ln.buff->size;
+
+    /*!< hit may be hidden by a narrow window, but is still valid */
+    if ((NULL == vln->sug.pidx) || (VLN_OFF_NONE == vln->sug.hit) ||
+        (vln->ln.curoff != size) || vln->ln.buff->mask || (vln->hist.index != 0) ||
+        ((uint16_t)(vln->sug.hit - vln->sug.out) >= (uint16_t)(vln->sug.in - vln->sug.out))) {
+        return 0;
+    }
+
+    rec = &vln->sug.pidx[vln->sug.hit & vln->sug.mask];
+
+    vln_edit_dirty(vln, size);
+
+    while ((size < rec->size) && (size < vln->ln.lnmax)) {
+        vln->ln.buff->pbuf[size] = vln_suggest_char(vln, rec, size);
+        size++;
+    }
+
+    VLN_UNDO_RECORD(vln, vln->ln.buff->size, 0, vln->ln.buff->pbuf + vln->ln.buff->size,
+                    size - vln->ln.buff->size);
+
+    vln->ln.buff->size = size;
+    vln->ln.curoff = size;
+
+    return 1;
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_suggest
+----------------------------------------------------------------------------*/
+#endif
+
+#if (defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE) || (defined(CFG_VLN_PAGER) && CFG_VLN_PAGER)
+
+/** @addtogroup vln_stage
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        send staged output
+* 
+* @param[in]    vln         
+* @param[in]    stg         staging buffer
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_stage_flush(vln_t *vln, vln_stage_t *stg)
+{
+    uint16_t len = stg->len;
+
+    if (len) {
+        stg->len = 0;
+        vln_put(vln, stg->pbuf, len, -1);
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        append to staged output, the buffer is sent when full and
+*               without buffer the data goes straight out. completion
+*               listings and pager screens go out this way so a screen
+*               costs a few sput calls instead of one per piece
+* 
+* @param[in]    vln         
+* @param[in]    stg         staging buffer
+* @param[in]    data        
+* @param[in]    size        
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_stage_emit(vln_t *vln, vln_stage_t *stg, const void *data, uint16_t size)
+{
+    const char *p = data;
+    uint16_t n;
+
+    while (size) {
+        if (stg->len == stg->size) {
+            if (vln_stage_flush(vln, stg)) {
+                return -1;
+            }
+
+            if (0 == stg->size) {
+                vln_put(vln, (void *)p, size, -1);
+                return 0;
+            }
+        }
+
+        n = stg->size - stg->len;
+        n = size < n ? size : n;
+        memcpy(stg->pbuf + stg->len, p, n);
+        stg->len += n;
+        p += n;
+        size -= n;
+    }
+
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_stage
+----------------------------------------------------------------------------*/
+#endif
+
+#if defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE
+
+/** @addtogroup vln_complete
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        pad listing row to the next column, CHA when it is shorter
+*               than the spaces
+* 
+* @param[in]    vln         
+* @param[in]    col         cells written on the row
+* @param[in]    n           cells to skip
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_complete_pad(vln_t *vln, uint16_t col, uint16_t n)
+{
+    const vln_profile_t *pf = vln_profile_get(vln);
+    size_t idx = 0;
+    uint8_t seq[8];
+    uint16_t step;
+
+    if (pf->cha && (((uint32_t)pf->cha + vln_print_width(col + n + 1)) < n)) {
+        vln_seqgen_cursor_absolute(seq, &idx, col + n + 1);
+        return vln_stage_emit(vln, &vln->cpl.out, (char *)seq, idx);
+    }
+
+    for (; n; n -= step) {
+        step = n > (uint16_t)sizeof(spaces) ? (uint16_t)sizeof(spaces) : n;
+        if (vln_stage_emit(vln, &vln->cpl.out, spaces, step)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        walk candidates of the word before cursor, get the widest
+*               and the prefix all of them share
+* 
+* @param[in]    vln         
+* @param[out]   first       first candidate
+* @param[out]   common      shared prefix size
+* 
+* @retval uint16_t          candidate count
+*****************************************************************************/
+static uint16_t vln_complete_scan(vln_t *vln, const char **first, uint16_t *common)
+{
+    const char *word = vln->ln.buff->pbuf + vln->cpl.word;
+    uint16_t len = vln->ln.curoff - vln->cpl.word;
+    const char *cand;
+    uint16_t size;
+    uint16_t i;
+    uint16_t n;
+
+    *first = NULL;
+    *common = 0;
+    vln->cpl.width = 0;
+
+    for (n = 0; n < UINT16_MAX; n++) {
+        cand = vln->cpl.cb(vln->cpl.arg, word, len, n);
+        if (NULL == cand) {
+            break;
+        }
+
+        size = (uint16_t)strlen(cand);
+
+        if (0 == n) {
+            *first = cand;
+            *common = size;
+        } else {
+            for (i = 0; (i < *common) && (cand[i] == (*first)[i]); i++) {
+            }
+            *common = i;
+        }
+
+        if (size > vln->cpl.width) {
+            vln->cpl.width = size;
+        }
+    }
+
+    return n;
+}
+
+/*****************************************************************************
+* @brief        insert text at cursor, as much as fits, without refresh
+*****************************************************************************/
+static void vln_complete_insert(vln_t *vln, const char *text, uint16_t n)
+{
+    uint16_t room = vln->ln.lnmax - vln->ln.buff->size;
+
+    n = n < room ? n : room;
+    if (0 == n) {
+        return;
+    }
+
+    VLN_UNDO_RECORD(vln, vln->ln.curoff, 0, text, n);
+
+    memmove(vln->ln.buff->pbuf + vln->ln.curoff + n,
+            vln->ln.buff->pbuf + vln->ln.curoff,
+            vln->ln.buff->size - vln->ln.curoff);
+    memcpy(vln->ln.buff->pbuf + vln->ln.curoff, text, n);
+
+    vln_edit_dirty(vln, vln->ln.curoff);
+    vln->ln.curoff += n;
+    vln->ln.buff->size += n;
+}
+
+/*****************************************************************************
+* @brief        list up to rows rows of candidates from cpl.next, rows are
+*               filled left to right so the callback is walked in order,
+*               a page that continues ends with --More-- and the last one
+*               with prompt and line drawn again
+* 
+* @param[in]    vln         
+* @param[in]    rows        rows to list
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_complete_page(vln_t *vln, uint16_t rows)
+{
+    const char *word = vln->ln.buff->pbuf + vln->cpl.word;
+    uint16_t len = vln->ln.curoff - vln->cpl.word;
+    uint16_t colw = vln->cpl.width + 2;
+    uint16_t n = vln->cpl.next;
+    const char *cand;
+    uint16_t size;
+    uint16_t col;
+    uint16_t c;
+
+    for (; rows && (n < vln->cpl.count); rows--) {
+        for (c = 0, col = 0; (c < vln->cpl.cols) && (n < vln->cpl.count); c++, n++) {
+            cand = vln->cpl.cb(vln->cpl.arg, word, len, n);
+            if (NULL == cand) {
+                /*!< candidates went away since the scan */
+                vln->cpl.count = n;
+                break;
+            }
+
+            if (c && vln_complete_pad(vln, col, c * colw - col)) {
+                return -1;
+            }
+
+            size = (uint16_t)strlen(cand);
+            if (vln_stage_emit(vln, &vln->cpl.out, cand, size)) {
+                return -1;
+            }
+            col = c * colw + size;
+        }
+
+        if (vln_stage_emit(vln, &vln->cpl.out, CFG_VLN_NEWLINE, sizeof(CFG_VLN_NEWLINE) - 1)) {
+            return -1;
+        }
+    }
+
+    if (n < vln->cpl.count) {
+        vln->cpl.next = n;
+        if (vln_stage_emit(vln, &vln->cpl.out, "--More--", 8)) {
+            return -1;
+        }
+        return vln_stage_flush(vln, &vln->cpl.out);
+    }
+
+    vln->cpl.next = 0;
+    if (vln_stage_flush(vln, &vln->cpl.out)) {
+        return -1;
+    }
+
+    vln->ln.cursor = VLN_OFF_NONE;
+    return vln_edit_reprompt(vln);
+}
+
+/*****************************************************************************
+* @brief        rows of a listing page, one row is kept for --More--
+*****************************************************************************/
+static uint16_t vln_complete_rows(vln_t *vln)
+{
+    return vln->term.row > 1 ? vln->term.row - 1 : 1;
+}
+
+/*****************************************************************************
+* @brief        complete word before cursor as far as the candidates agree,
+*               list them when that adds nothing
+* 
+* @param[in]    vln         
+* @param[in]    list        list without completing
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_complete_word(vln_t *vln, uint8_t list)
+{
+    const char *first;
+    uint16_t common;
+    uint16_t count;
+    uint16_t len;
+    uint16_t off;
+
+    if ((NULL == vln->cpl.cb) || vln->ln.buff->mask) {
+        return 0;
+    }
+
+    for (off = vln->ln.curoff; (off > 0) && (vln->ln.buff->pbuf[off - 1] != ' '); off--) {
+    }
+
+    vln->cpl.word = off;
+    len = vln->ln.curoff - off;
+
+    count = vln_complete_scan(vln, &first, &common);
+    if (0 == count) {
+        return 0;
+    }
+
+    if (!list && ((common > len) || (1 == count))) {
+        if (common > len) {
+            vln_complete_insert(vln, first + len, common - len);
+        }
+
+        /*!< a unique word at line end is finished with a space */
+        if ((1 == count) && (vln->ln.curoff == vln->ln.buff->size)) {
+            vln_complete_insert(vln, " ", 1);
+        }
+
+        return vln_edit_refresh(vln);
+    }
+
+    vln->cpl.count = count;
+    vln->cpl.next = 0;
+    vln->cpl.cols = (vln->term.col + 1) / (vln->cpl.width + 2);
+    if (0 == vln->cpl.cols) {
+        vln->cpl.cols = 1;
+    }
+
+    /*!< listing starts below the line */
+    if (vln_edit_leave(vln) || vln_edit_sgr(vln, 0) ||
+        vln_stage_emit(vln, &vln->cpl.out, CFG_VLN_NEWLINE, sizeof(CFG_VLN_NEWLINE) - 1)) {
+        return -1;
+    }
+
+    return vln_complete_page(vln, vln_complete_rows(vln));
+}
+
+/*****************************************************************************
+* @brief        key at --More--, space lists the next page and enter the
+*               next row, q ends the listing, any other key ends it too and
+*               is then handled as usual
+* 
+* @param[in]    vln         
+* @param[in]    c           input byte
+* 
+* @retval int               1:Key consumed 0:Handle key -1:Error
+*****************************************************************************/
+static int vln_complete_more(vln_t *vln, uint8_t c)
+{
+    uint16_t rows = 0;
+
+    if ('\n' == c) {
+        /*!< second half of CR LF */
+        return 1;
+    }
+
+    if (vln_profile_get(vln)->esc) {
+        vln_put(vln, "\r\e[K", 4, -1);
+    } else {
+        vln_put(vln, "\r        \r", 10, -1);
+    }
+
+    if (' ' == c) {
+        rows = vln_complete_rows(vln);
+    } else if ('\r' == c) {
+        rows = 1;
+    }
+
+    if (rows) {
+        return vln_complete_page(vln, rows) ? -1 : 1;
+    }
+
+    vln->cpl.next = 0;
+    vln->ln.cursor = VLN_OFF_NONE;
+    if (vln_edit_reprompt(vln)) {
+        return -1;
+    }
+
+    return ('q' == c) ? 1 : 0;
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_complete
+----------------------------------------------------------------------------*/
+#endif
+
+/*****************************************************************************
+* @brief        get an input byte, the rx buffer is refilled by a single
+*               sget call for up to CFG_VLN_RXBUF bytes
+* 
+* @param[in]    vln         
+* @param[out]   c           input byte
+* 
+* @retval uint8_t           1:Got a byte 0:No input
+*****************************************************************************/
+static uint8_t vln_getc(vln_t *vln, uint8_t *c)
+{
+#if defined(CFG_VLN_RXBUF) && CFG_VLN_RXBUF
+    if (vln->rx.off >= vln->rx.len) {
+        vln->rx.off = 0;
+        vln->rx.len = vln->sget(vln->rx.pbuf, CFG_VLN_RXBUF);
+
+        if (0 == vln->rx.len) {
+            return 0;
+        }
+    }
+
+    *c = vln->rx.pbuf[vln->rx.off++];
+    return 1;
+#else
+    return vln->sget(c, 1) ? 1 : 0;
+#endif
+}
+
+/*****************************************************************************
+* @brief        give up terminal detection after timeout
+*****************************************************************************/
+static void vln_detect_poll(vln_t *vln)
+{
+    if (vln->term.detect && (NULL != vln->tick) &&
+        ((uint32_t)(vln->tick() - vln->term.dtick) >= CFG_VLN_DETECT_TIMEOUT)) {
+        vln->term.detect = 0;
+
+        if (vln->term.type == VLN_TERM_UNKNOWN) {
+            vln->term.type = VLN_TERM_DUMB;
+
+#if defined(CFG_VLN_HEADLESS) && CFG_VLN_HEADLESS
+            /*!< nothing answers, input comes from a script or a rig */
+            if (VLN_HEADLESS_AUTO == vln->hdl.mode) {
+                vln->hdl.mode = VLN_HEADLESS_ON;
+            }
+#endif
+        }
+    }
+}
+
+/*****************************************************************************
+* @brief        no input ready, sleep in the wait callback until input may
+*               have arrived or the nearest timeout is due. without the
+*               callback this returns at once and the caller keeps polling
+*****************************************************************************/
+static void vln_idle(vln_t *vln)
+{
+    /*!< a due detection timeout would otherwise never let the wait sleep */
+    vln_detect_poll(vln);
+
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    vln_status_poll(vln);
+#endif
+
+    if (NULL != vln->wait) {
+        vln->wait(vln_timeout(vln));
+    }
+}
+
+/*****************************************************************************
+* @brief        wait switch to altscreen
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+__unused static int vln_wait_altscreen(vln_t *vln)
+{
+    uint8_t c = 0;
+
+    for (;;) {
+        vln_waitkey(vln, &c);
+
+        if ((c == VLN_C0_CR) || (c == VLN_C0_LF)) {
+            vln_put(vln, "\e[?47h", 6, -1);
+            vln->term.alt = 1;
+            return 0;
+        }
+    }
+}
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+/*****************************************************************************
+* @brief        start a paste, the bytes after the cursor are parked at the
+*               end of linebuff so pasted bytes are appended in place
+*****************************************************************************/
+static void vln_paste_begin(vln_t *vln)
+{
+    uint16_t tail = vln->ln.buff->size - vln->ln.curoff;
+
+    if (vln->ln.paste) {
+        return;
+    }
+
+    if (tail) {
+        memmove(vln->ln.buff->pbuf + vln->ln.lnmax - tail, vln->ln.buff->pbuf + vln->ln.curoff, tail);
+    }
+
+    vln->ln.paste = 1;
+    vln->ln.pfrom = vln->ln.curoff;
+    vln->ln.ptail = tail;
+    vln->ln.ptick = (NULL != vln->tick) ? vln->tick() : 0;
+    vln->ln.buff->size = vln->ln.curoff;
+}
+
+/*****************************************************************************
+* @brief        end a paste, join the parked bytes back in one move, journal
+*               the paste as one insert and repaint once
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_paste_end(vln_t *vln)
+{
+    char *pbuf = vln->ln.buff->pbuf;
+
+    if (!vln->ln.paste) {
+        return 0;
+    }
+
+    vln->ln.paste = 0;
+
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    /*!< the paste went to the stream callback */
+    if (vln->stm.on) {
+        return 0;
+    }
+#endif
+
+    if (vln->ln.ptail) {
+        memmove(pbuf + vln->ln.curoff, pbuf + vln->ln.lnmax - vln->ln.ptail, vln->ln.ptail);
+        vln->ln.buff->size += vln->ln.ptail;
+        vln->ln.ptail = 0;
+    }
+
+    if (vln->ln.curoff != vln->ln.pfrom) {
+        VLN_UNDO_RECORD(vln, vln->ln.pfrom, 0, pbuf + vln->ln.pfrom, vln->ln.curoff - vln->ln.pfrom);
+        vln_edit_dirty(vln, vln->ln.pfrom);
+    }
+
+    return vln_edit_refresh(vln);
+}
+
+/*****************************************************************************
+* @brief        end a paste that stalled, its end marker was lost
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_paste_expire(vln_t *vln)
+{
+    if (!vln->ln.paste || (NULL == vln->tick) ||
+        ((uint32_t)(vln->tick() - vln->ln.ptick) < CFG_VLN_PASTE_TIMEOUT)) {
+        return 0;
+    }
+
+    return vln_paste_end(vln);
+}
+
+/*****************************************************************************
+* @brief        append a pasted byte at the cursor, nothing is moved or
+*               drawn until the paste ends. line breaks and tabs become
+*               spaces, other control bytes are dropped so nothing pasted
+*               can submit or edit the line
+* 
+* @param[in]    vln         
+* @param[in]    c           pasted byte
+*****************************************************************************/
+static void vln_edit_paste(vln_t *vln, uint8_t c)
+{
+    uint8_t cr = (vln->ln.paste == 2);
+
+    vln->ln.paste = (c == VLN_C0_CR) ? 2 : 1;
+    vln->ln.ptick = (NULL != vln->tick) ? vln->tick() : 0;
+
+    if ((c == VLN_C0_LF) && cr) {
+        return;
+    }
+
+    if ((c == VLN_C0_CR) || (c == VLN_C0_LF) || (c == VLN_C0_HT)) {
+        c = ' ';
+    } else if ((c < VLN_G0_BEG) || (c > VLN_G0_END)) {
+        return;
+    }
+
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    /*!< only a paste at line end streams, nothing is parked then */
+    if (vln->stm.on || (!vln->ln.ptail && (vln->ln.buff->size >= vln->ln.lnmax))) {
+        vln_stream_insert(vln, (char)c);
+        return;
+    }
+#endif
+
+    if ((vln->ln.curoff + vln->ln.ptail) >= vln->ln.lnmax) {
+        return;
+    }
+
+    vln->ln.buff->pbuf[vln->ln.curoff++] = c;
+    vln->ln.buff->size++;
+}
+#endif
+
+/*****************************************************************************
+* @brief        execute an editing key
+* 
+* @param[in]    vln         
+* @param[in]    c           key after dispatch
+* 
+* @retval int               1:Line complete 0:Continue -1:Error
+*****************************************************************************/
+static int vln_exec(vln_t *vln, uint8_t c)
+{
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    if (vln->stm.on) {
+        return vln_stream_key(vln, c);
+    }
+#endif
+
+    /*!< hanlder control */
+    switch (c) {
+        /*!< ignore */
+        default:
+        case VLN_EXEC_NUL:
+            break;
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+        /*!< bracketed paste, bytes go to vln_edit_paste until the end */
+        case VLN_EXEC_PSBG:
+            vln_paste_begin(vln);
+            break;
+
+        case VLN_EXEC_PSED:
+            if (vln_paste_end(vln)) {
+                return -1;
+            }
+            break;
+#endif
+
+        /*!< clear screen and refresh line */
+        case VLN_EXEC_CLR:
+            if (vln_edit_clear(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< newline */
+        case VLN_EXEC_NLN:
+#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
+            vln_history_store(vln);
+#endif
+            return 1;
+
+        /*!< abortline */
+        case VLN_EXEC_ALN:
+            vln->ln.buff->size = 0;
+            return 1;
+
+        /*!< delete */
+        case VLN_EXEC_DEL:
+            if (vln_edit_delete(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< backspace */
+        case VLN_EXEC_BS:
+            if (vln_edit_backspace(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< move right, accept suggestion at end of line */
+        case VLN_EXEC_MVRT:
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+            if (vln_suggest_accept(vln)) {
+                if (vln_edit_refresh(vln)) {
+                    return -1;
+                }
+                break;
+            }
+#endif
+            if (vln_edit_moveright(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< move left */
+        case VLN_EXEC_MVLT:
+            if (vln_edit_moveleft(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< move end */
+        case VLN_EXEC_MVED:
+            if (vln_edit_moveend(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< move home */
+        case VLN_EXEC_MVHM:
+            if (vln_edit_movehome(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< fetch next history */
+        case VLN_EXEC_NXTH:
+#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
+            if (vln_history_loadnext(vln)) {
+                return -1;
+            }
+#endif
+            break;
+
+        /*!< fetch prev history */
+        case VLN_EXEC_PRVH:
+#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
+            if (vln_history_loadprev(vln)) {
+                return -1;
+            }
+#endif
+            break;
+
+        /*!< delete prev word */
+        case VLN_EXEC_DLWD:
+            if (vln_edit_delword(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< delete whole line */
+        case VLN_EXEC_DHLN:
+            if (vln_edit_delline(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< delete cursor to end */
+        case VLN_EXEC_DELN:
+            if (vln_edit_delend(vln)) {
+                return -1;
+            }
+            break;
+
+        /*!< list completions */
+        case VLN_EXEC_SCPT:
+#if defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE
+            if (vln_complete_word(vln, 1)) {
+                return -1;
+            }
+#endif
+            break;
+
+        /*!< auto complete */
+        case VLN_EXEC_ACPT:
+#if defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE
+            if (vln_complete_word(vln, 0)) {
+                return -1;
+            }
+#endif
+            break;
+
+        /*!< switch to normal screen */
+        case VLN_EXEC_SWNM:
+#if defined(CFG_VLN_XTERM) && CFG_VLN_XTERM
+            if (vln->term.nsupt == 0) {
+                vln_put(vln, "\e[?47l", 6, -1);
+                vln->term.alt = 0;
+            }
+#endif
+            break;
+
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+        /*!< undo last edit */
+        case VLN_EXEC_UNDO:
+            if (vln_undo_apply(vln, 0)) {
+                return -1;
+            }
+            break;
+
+        /*!< redo undone edit */
+        case VLN_EXEC_REDO:
+            if (vln_undo_apply(vln, 1)) {
+                return -1;
+            }
+            break;
+#endif
+
+        case VLN_EXEC_HELP:
+            if (vln_edit_leave(vln) || vln_help(vln)) {
+                return -1;
+            }
+            vln->ln.buff->size = 0;
+            vln->ln.cursor = VLN_OFF_NONE;
+            return 1;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        decode one input byte into a printable or an editing key
+* 
+* @param[in]    vln         
+* @param[in]    c           input byte
+* 
+* @retval int               1:Line complete 0:Continue -1:Error
+*****************************************************************************/
+static int vln_decode(vln_t *vln, uint8_t c)
+{
+    int ret;
+
+#if defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE
+    if (vln->cpl.next) {
+        ret = vln_complete_more(vln, c);
+        if (ret) {
+            return ret < 0 ? -1 : 0;
+        }
+    }
+#endif
+
+    if ((VLN_C0_ESC == c) || (VLN_SEQ_NONE != vln->seq.state)) {
+        if (vln_seqexec(vln, &c)) {
+            return -1;
+        }
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+        /*!< keys inside paste are dropped, only the end marker counts */
+        if (vln->ln.paste && (c != VLN_EXEC_PSED)) {
+            return 0;
+        }
+    } else if (vln->ln.paste) {
+        vln_edit_paste(vln, c);
+        return 0;
+#endif
+    } else if (c & 0x80) {
+        /*!< not support 8bit code */
+        return 0;
+    } else if (VLN_G0_BEG <= c) {
+        if (c <= VLN_G0_END) {
+            /*!< printable characters */
+            VLN_PROBE_BEGIN(vln, insert);
+            ret = vln_edit_insert(vln, c);
+            VLN_PROBE_END(vln, insert, VLN_PROBE_EDIT);
+            return ret;
+        }
+
+        /*!< delete */
+        c = VLN_EXEC_BS;
+    } else {
+        if (vln_dispatch_ctrl(vln, &c, vln->seq.pns)) {
+            return -1;
+        }
+    }
+
+    VLN_PROBE_BEGIN(vln, edit);
+    ret = vln_exec(vln, c);
+    VLN_PROBE_END(vln, edit, VLN_PROBE_EDIT);
+
+    return ret;
+}
+
+/*****************************************************************************
+* @brief        resolve a sequence that stalled longer than
+*               CFG_VLN_ESC_TIMEOUT, a lone esc becomes its own key and
+*               any other partial sequence is dropped. a paste that stalled
+*               or got a lone esc ends there
+* 
+* @param[in]    vln         
+* 
+* @retval int               1:Line complete 0:Continue -1:Error
+*****************************************************************************/
+static int vln_seqexpire(vln_t *vln)
+{
+    uint8_t c = VLN_C0_ESC;
+    uint8_t state = vln->seq.state;
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+    if (vln_paste_expire(vln)) {
+        return -1;
+    }
+#endif
+
+    if ((VLN_SEQ_NONE == state) || (NULL == vln->tick) ||
+        ((uint32_t)(vln->tick() - vln->seq.tick) < vln_seqtimeout(vln))) {
+        return 0;
+    }
+
+    vln->seq.state = VLN_SEQ_NONE;
+
+#if defined(CFG_VLN_FRAME) && CFG_VLN_FRAME
+    if (VLN_SEQ_FRAME == state) {
+        return vln_frame_expire(vln);
+    }
+#endif
+
+    if (VLN_SEQ_ESC != state) {
+        return 0;
+    }
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+    /*!< a lone esc ends a paste whose end marker was lost */
+    if (vln->ln.paste) {
+        return vln_paste_end(vln);
+    }
+#endif
+
+    if (vln_dispatch_ctrl(vln, &c, vln->seq.pns)) {
+        return -1;
+    }
+
+    return vln_exec(vln, c);
+}
+
+/*****************************************************************************
+* @brief        handle one input byte
+* 
+* @param[in]    vln         
+* @param[in]    c           input byte
+* 
+* @retval int               1:Line complete 0:Continue -1:Error
+*****************************************************************************/
+static int vln_input(vln_t *vln, uint8_t c)
+{
+    int ret;
+
+#if defined(CFG_VLN_XTERM) && CFG_VLN_XTERM
+    /*!< wait switch to altscreen */
+    if (vln->term.altnsupt == 0) {
+        if ((c == VLN_C0_CR) || (c == VLN_C0_LF)) {
+            vln_put(vln, "\e[?47h", 6, -1);
+            vln->term.alt = 1;
+        }
+        return 0;
+    }
+#endif
+
+    /*!< a byte arriving after the timeout does not belong to the sequence */
+    ret = vln_seqexpire(vln);
+    if (ret) {
+        return ret;
+    }
+
+    /*!< parse is what remains after the nested stages */
+    VLN_PROBE_BEGIN(vln, parse);
+    ret = vln_decode(vln, c);
+    VLN_PROBE_END(vln, parse, VLN_PROBE_PARSE);
+
+    return ret;
+}
+
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+
+/** @addtogroup vln_pager
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        text rows, the last row is kept for the status
+*****************************************************************************/
+static uint16_t vln_pager_rows(vln_t *vln)
+{
+    return vln->term.row > 1 ? vln->term.row - 1 : 1;
+}
+
+/*****************************************************************************
+* @brief        get line n from the source, remembers where the output ends
+* 
+* @param[in]    vln         
+* @param[in]    n           line number from 0
+* @param[out]   size        line size
+* 
+* @retval char*             line, NULL past the last line
+*****************************************************************************/
+static const char *vln_pager_line(vln_t *vln, uint32_t n, uint16_t *size)
+{
+    const char *line;
+
+    if (n >= vln->pgr.end) {
+        return NULL;
+    }
+
+    line = vln->pgr.cb(vln->pgr.arg, n, size);
+    if (NULL == line) {
+        /*!< lines are contiguous, none follows a missing one */
+        vln->pgr.end = n;
+    }
+
+    return line;
+}
+
+/*****************************************************************************
+* @brief        output line n cut to the screen width, control bytes are
+*               shown as spaces so the text never moves the cursor
+* 
+* @param[in]    vln         
+* @param[in]    n           line number
+* 
+* @retval int               1:Line written 0:Past the last line -1:Error
+*****************************************************************************/
+static int vln_pager_text(vln_t *vln, uint32_t n)
+{
+    const char *line;
+    uint16_t cells = 0;
+    uint16_t from = 0;
+    uint16_t size;
+    uint16_t i;
+    uint8_t c;
+
+    line = vln_pager_line(vln, n, &size);
+    if (NULL == line) {
+        return 0;
+    }
+
+    for (i = 0; i < size; i++) {
+        c = (uint8_t)line[i];
+
+        /*!< utf-8 continuation bytes share the cell of their lead byte */
+        if (0x80 != (c & 0xc0)) {
+            if (cells == vln->term.col) {
+                break;
+            }
+            cells++;
+        }
+
+        if ((c < VLN_C0_SP) || (VLN_C0_DEL == c)) {
+            if (vln_stage_emit(vln, &vln->pgr.out, line + from, i - from) || vln_stage_emit(vln, &vln->pgr.out, " ", 1)) {
+                return -1;
+            }
+            from = i + 1;
+        }
+    }
+
+    return vln_stage_emit(vln, &vln->pgr.out, line + from, i - from) ? -1 : 1;
+}
+
+/*****************************************************************************
+* @brief        output count lines from line n on the rows from the cursor
+*               down, stops at the last line
+* 
+* @param[in]    vln         
+* @param[in]    n           first line
+* @param[in]    count       rows to fill
+* @param[in]    tail        end the last row with a newline too
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_pager_lines(vln_t *vln, uint32_t n, uint16_t count, uint8_t tail)
+{
+    int ret;
+
+    for (; count; count--, n++) {
+        ret = vln_pager_text(vln, n);
+        if (ret <= 0) {
+            return ret;
+        }
+
+        /*!< a newline on the bottom row would scroll the region */
+        if (((count > 1) || tail) &&
+            vln_stage_emit(vln, &vln->pgr.out, CFG_VLN_NEWLINE, sizeof(CFG_VLN_NEWLINE) - 1)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        print a 32bit line number
+*****************************************************************************/
+static void vln_pager_number(char *buf, size_t *idx, uint32_t value)
+{
+    char digits[10];
+    uint8_t n = 0;
+
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    while (n) {
+        buf[(*idx)++] = digits[--n];
+    }
+}
+
+/*****************************************************************************
+* @brief        take the status off a dumb terminal, the cursor is left at
+*               the start of its row
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_pager_unstatus(vln_t *vln)
+{
+    uint8_t n = vln->pgr.slen;
+    uint8_t step;
+
+    if (0 == n) {
+        return 0;
+    }
+
+    if (vln_stage_emit(vln, &vln->pgr.out, "\r", 1)) {
+        return -1;
+    }
+
+    for (; n; n -= step) {
+        step = n > (uint8_t)sizeof(spaces) ? (uint8_t)sizeof(spaces) : n;
+        if (vln_stage_emit(vln, &vln->pgr.out, spaces, step)) {
+            return -1;
+        }
+    }
+
+    vln->pgr.slen = 0;
+    return vln_stage_emit(vln, &vln->pgr.out, "\r", 1);
+}
+
+/*****************************************************************************
+* @brief        output the status row: the pattern being typed, a failed
+*               search, or the lines on screen and (END) after the last one
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_pager_status(vln_t *vln)
+{
+    uint32_t last = vln->pgr.top + vln_pager_rows(vln);
+    char text[CFG_VLN_PAGER_PATTERN + 28];
+    uint8_t seq[16];
+    size_t idx = 0;
+    size_t len = 0;
+    uint16_t size;
+
+    if (vln->pgr.find) {
+        text[len++] = '/';
+        memcpy(text + len, vln->pgr.pat, vln->pgr.plen);
+        len += vln->pgr.plen;
+    } else if (vln->pgr.miss) {
+        memcpy(text, "Pattern not found", 17);
+        len = 17;
+    } else {
+        memcpy(text, "lines ", 6);
+        len = 6;
+        vln_pager_number(text, &len, vln->pgr.top + 1);
+        text[len++] = '-';
+
+        if (NULL == vln_pager_line(vln, last, &size)) {
+            last = vln->pgr.end < last ? vln->pgr.end : last;
+            vln_pager_number(text, &len, last);
+            memcpy(text + len, " (END)", 6);
+            len += 6;
+        } else {
+            vln_pager_number(text, &len, last);
+        }
+    }
+
+    if (!vln->pgr.scr && vln_pager_unstatus(vln)) {
+        return -1;
+    }
+
+    /*!< the status must not wrap, that would scroll the screen */
+    if (len >= vln->term.col) {
+        len = vln->term.col - 1;
+    }
+
+    vln->pgr.slen = (uint8_t)len;
+
+    if (vln->pgr.scr) {
+        vln_seqgen_cursor_position(seq, &idx, vln->term.row, 1);
+        vln_seqgen_csi0(seq, &idx, 'K');
+
+        if (vln->pgr.find) {
+            return vln_stage_emit(vln, &vln->pgr.out, seq, idx) || vln_stage_emit(vln, &vln->pgr.out, text, len);
+        }
+
+        memcpy(seq + idx, "\e[7m", 4);
+        idx += 4;
+        return vln_stage_emit(vln, &vln->pgr.out, seq, idx) || vln_stage_emit(vln, &vln->pgr.out, text, len) ||
+               vln_stage_emit(vln, &vln->pgr.out, "\e[m", 3);
+    }
+
+    return vln_stage_emit(vln, &vln->pgr.out, text, len);
+}
+
+/*****************************************************************************
+* @brief        show the page from line top, rows that stay on screen are
+*               moved with SU or SD and only the rows coming in are written,
+*               a dumb terminal scrolls forward with newlines and prints the
+*               whole page again for any other move
+* 
+* @param[in]    vln         
+* @param[in]    top         line on the first row
+* @param[in]    all         write every row
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_pager_show(vln_t *vln, uint32_t top, uint8_t all)
+{
+    uint16_t rows = vln_pager_rows(vln);
+    uint32_t old = vln->pgr.top;
+    uint8_t seq[32];
+    size_t idx = 0;
+    uint16_t n;
+
+    vln->pgr.top = top;
+
+    if (!vln->pgr.scr) {
+        if (vln_pager_unstatus(vln)) {
+            return -1;
+        }
+
+        if (!all && (top >= old) && ((top - old) < rows)) {
+            n = (uint16_t)(top - old);
+            return vln_pager_lines(vln, old + rows, n, 1) || vln_pager_status(vln);
+        }
+
+        return vln_pager_lines(vln, top, rows, 1) || vln_pager_status(vln);
+    }
+
+    /*!< text rows scroll, the status row below them stays */
+    if (rows != vln->pgr.rows) {
+        vln->pgr.rows = rows;
+        vln_seqgen_csi2(seq, &idx, 'r', 1, rows);
+        all = 1;
+    }
+
+    if (!all && (top == old)) {
+        return vln_pager_status(vln);
+    }
+
+    if (!all && (top > old) && ((top - old) < rows)) {
+        n = (uint16_t)(top - old);
+        vln_seqgen_scroll_up(seq, &idx, n);
+        vln_seqgen_cursor_position(seq, &idx, rows - n + 1, 1);
+        top = old + rows;
+    } else if (!all && (top < old) && ((old - top) < rows)) {
+        n = (uint16_t)(old - top);
+        vln_seqgen_scroll_down(seq, &idx, n);
+        vln_seqgen_cursor_position(seq, &idx, 1, 1);
+    } else {
+        n = rows;
+        vln_seqgen_cursor_position(seq, &idx, 1, 1);
+        vln_seqgen_csi0(seq, &idx, 'J');
+    }
+
+    return vln_stage_emit(vln, &vln->pgr.out, seq, idx) || vln_pager_lines(vln, top, n, 0) ||
+           vln_pager_status(vln);
+}
+
+/*****************************************************************************
+* @brief        lines the page can move forward, up to n, it stops once the
+*               last line is on the bottom row
+*****************************************************************************/
+static uint32_t vln_pager_ahead(vln_t *vln, uint32_t n)
+{
+    uint32_t first = vln->pgr.top + vln_pager_rows(vln);
+    uint32_t lo = 0;
+    uint32_t mid;
+    uint16_t size;
+
+    if (n > (UINT32_MAX - first)) {
+        n = UINT32_MAX - first;
+    }
+
+    /*!< a line that exists answers for all lines before it */
+    if ((0 == n) || vln_pager_line(vln, first + n - 1, &size)) {
+        return n;
+    }
+
+    /*!< bisect the last line, G on a long output costs about 32 calls */
+    for (n--; lo < n;) {
+        mid = lo + (n - lo + 1) / 2;
+        if (vln_pager_line(vln, first + mid - 1, &size)) {
+            lo = mid;
+        } else {
+            n = mid - 1;
+        }
+    }
+
+    return lo;
+}
+
+/*****************************************************************************
+* @brief        is the pattern in the line
+*****************************************************************************/
+static uint8_t vln_pager_match(vln_t *vln, const char *line, uint16_t size)
+{
+    const char *end = line + size;
+    uint16_t plen = vln->pgr.plen;
+
+    while ((uint16_t)(end - line) >= plen) {
+        line = memchr(line, vln->pgr.pat[0], (end - line) - plen + 1);
+        if (NULL == line) {
+            return 0;
+        }
+
+        if (0 == memcmp(line, vln->pgr.pat, plen)) {
+            return 1;
+        }
+        line++;
+    }
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        move the page to the next line holding the pattern, after
+*               the top line or before it
+* 
+* @param[in]    vln         
+* @param[in]    back        search towards the first line
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_pager_search(vln_t *vln, uint8_t back)
+{
+    uint32_t n = vln->pgr.top;
+    const char *line;
+    uint16_t size;
+
+    if (0 == vln->pgr.plen) {
+        return vln_pager_status(vln);
+    }
+
+    while (back ? (n > 0) : (n < UINT32_MAX)) {
+        n = back ? n - 1 : n + 1;
+
+        line = vln_pager_line(vln, n, &size);
+        if (NULL == line) {
+            break;
+        }
+
+        if (vln_pager_match(vln, line, size)) {
+            return vln_pager_show(vln, n, 0);
+        }
+    }
+
+    vln->pgr.miss = 1;
+    return vln_pager_status(vln);
+}
+
+/*****************************************************************************
+* @brief        leave the pager, back to the normal screen
+* @retval int               1:Closed -1:Error
+*****************************************************************************/
+static int vln_pager_close(vln_t *vln)
+{
+    uint8_t seq[24];
+    size_t idx = 0;
+
+    vln->pgr.cb = NULL;
+
+    if (!vln->pgr.scr) {
+        return vln_pager_unstatus(vln) ? -1 : 1;
+    }
+
+    /*!< 1.whole screen scrolls again   <esc>[r     */
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    if (NULL != vln->sts.shown) {
+        /*!< or the rows above the status row */
+        vln_seqgen_csi2(seq, &idx, 'r', 1, vln->term.row);
+    } else
+#endif
+    {
+        vln_seqgen_csi0(seq, &idx, 'r');
+    }
+
+    if (vln->term.alt) {
+        /*!< the editor lives on the alternate screen, clear it instead */
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+        vln_status_lost(vln);
+#endif
+        memcpy(seq + idx, "\e[2J\e[H", 7);
+        return vln_stage_emit(vln, &vln->pgr.out, seq, idx + 7) ? -1 : 1;
+    }
+
+    /*!< 2.enter normal screen buffer   <esc>[?47l  */
+    /*!< 3.restore cursor               <esc>8      */
+    memcpy(seq + idx, "\e[?47l\e8", 8);
+    return vln_stage_emit(vln, &vln->pgr.out, seq, idx + 8) ? -1 : 1;
+}
+
+/*****************************************************************************
+* @brief        key typed into the search pattern, enter searches, backspace
+*               on an empty pattern or ctrl-c cancels
+* 
+* @param[in]    vln         
+* @param[in]    key         printable key, 0 for an editing key
+* @param[in]    c           editing key
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_pager_find(vln_t *vln, uint8_t key, uint8_t c)
+{
+    if (key) {
+        if (vln->pgr.plen < sizeof(vln->pgr.pat)) {
+            vln->pgr.pat[vln->pgr.plen++] = (char)key;
+        }
+    } else if (VLN_EXEC_BS == c) {
+        if (vln->pgr.plen) {
+            vln->pgr.plen--;
+        } else {
+            vln->pgr.find = 0;
+        }
+    } else if (VLN_EXEC_NLN == c) {
+        vln->pgr.find = 0;
+        return vln_pager_search(vln, 0);
+    } else if (VLN_EXEC_ALN == c) {
+        vln->pgr.find = 0;
+        vln->pgr.plen = 0;
+    } else {
+        return 0;
+    }
+
+    return vln_pager_status(vln);
+}
+
+/*****************************************************************************
+* @brief        handle a key while paging
+* 
+* @param[in]    vln         
+* @param[in]    c           input byte
+* 
+* @retval int               1:Closed 0:Continue -1:Error
+*****************************************************************************/
+static int vln_pager_key(vln_t *vln, uint8_t c)
+{
+    uint16_t rows = vln_pager_rows(vln);
+    uint32_t top = vln->pgr.top;
+    uint8_t key = 0;
+
+    if ((VLN_C0_ESC == c) || (VLN_SEQ_NONE != vln->seq.state)) {
+        if (vln_seqexec(vln, &c)) {
+            return -1;
+        }
+    } else if ((VLN_G0_BEG <= c) && (c <= VLN_G0_END)) {
+        key = c;
+    } else if (VLN_C0_LF == c) {
+        /*!< second half of CR LF */
+        return 0;
+    } else if (c < VLN_C0_SP) {
+        if (vln_dispatch_ctrl(vln, &c, vln->seq.pns)) {
+            return -1;
+        }
+    } else {
+        /*!< delete, 8bit codes are dropped */
+        c = (VLN_C0_DEL == c) ? VLN_EXEC_BS : VLN_EXEC_NUL;
+    }
+
+    if (vln->pgr.find) {
+        return vln_pager_find(vln, key, c);
+    }
+
+    vln->pgr.miss = 0;
+
+    switch (key) {
+        case 0:
+            break;
+        case 'q':
+        case 'Q':
+            return vln_pager_close(vln);
+        case ' ':
+        case 'f':
+            c = VLN_EXEC_PGDN;
+            break;
+        case 'b':
+            c = VLN_EXEC_PGUP;
+            break;
+        case 'j':
+            c = VLN_EXEC_NXTH;
+            break;
+        case 'k':
+            c = VLN_EXEC_PRVH;
+            break;
+        case 'g':
+        case '<':
+            c = VLN_EXEC_MVHM;
+            break;
+        case 'G':
+        case '>':
+            c = VLN_EXEC_MVED;
+            break;
+        case 'd':
+            return vln_pager_show(vln, top + vln_pager_ahead(vln, rows / 2), 0);
+        case 'u':
+            return vln_pager_show(vln, top - ((rows / 2) < top ? (rows / 2) : top), 0);
+        case '/':
+            vln->pgr.find = 1;
+            vln->pgr.plen = 0;
+            return vln_pager_show(vln, top, 0);
+        case 'n':
+            return vln_pager_search(vln, 0);
+        case 'N':
+            return vln_pager_search(vln, 1);
+        default:
+            return 0;
+    }
+
+    switch (c) {
+        case VLN_EXEC_ALN:
+            return vln_pager_close(vln);
+        case VLN_EXEC_NLN:
+        case VLN_EXEC_NXTH:
+            return vln_pager_show(vln, top + vln_pager_ahead(vln, 1), 0);
+        case VLN_EXEC_PRVH:
+            return vln_pager_show(vln, top - (top ? 1 : 0), 0);
+        case VLN_EXEC_PGDN:
+            return vln_pager_show(vln, top + vln_pager_ahead(vln, rows), 0);
+        case VLN_EXEC_PGUP:
+            return vln_pager_show(vln, top - (rows < top ? rows : top), 0);
+        case VLN_EXEC_MVHM:
+            return vln_pager_show(vln, 0, 0);
+        case VLN_EXEC_MVED:
+            return vln_pager_show(vln, top + vln_pager_ahead(vln, UINT32_MAX), 0);
+        case VLN_EXEC_CLR:
+            vln->pgr.rows = 0;
+            return vln_pager_show(vln, top, 1);
+        default:
+            return 0;
+    }
+}
+
+/*****************************************************************************
+* @brief        feed input to the pager until it is closed
+* 
+* @param[in]    vln         
+* @param[in]    block       wait for input, else return once it runs dry
+* 
+* @retval int               1:Still paging 0:Closed -1:Error
+*****************************************************************************/
+static int vln_pager_run(vln_t *vln, uint8_t block)
+{
+    uint8_t c;
+    int ret;
+
+    while (NULL != vln->pgr.cb) {
+        if (0 == vln_getc(vln, &c)) {
+            /*!< a lone esc means nothing to the pager, it only ends the sequence */
+            vln_seqexpire(vln);
+
+            if (!block) {
+                return 1;
+            }
+
+            vln_idle(vln);
+            continue;
+        }
+
+        ret = vln_pager_key(vln, c);
+        if ((ret < 0) || vln_stage_flush(vln, &vln->pgr.out)) {
+            vln->pgr.cb = NULL;
+            vln->pgr.out.len = 0;
+            return -1;
+        }
+    }
+
+    /*!< a sequence cut by closing must not leak into the line */
+    vln->seq.state = VLN_SEQ_NONE;
+    return 0;
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_pager
+----------------------------------------------------------------------------*/
+#endif
+
+/*****************************************************************************
+* @brief        start a new line, output prompt
+* 
+* @param[in]    vln         
+* @param[in]    linebuff    linebuff pointer
+* @param[in]    buffsize    linebuff size
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_line_begin(vln_t *vln, char *linebuff, uint32_t buffsize)
+{
+    vln->ln.buff = (void *)linebuff;
+    vln->ln.buff->size = 0;
+    vln->ln.buff->mask = vln->ln.mask;
+    vln->ln.lnmax = buffsize - 5; /*!< reserved for \0 and size */
+    vln->ln.curoff = 0;
+
+#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
+    vln->hist.index = 0;
+#endif
+
+    /*!< a plain prompt may be edited in place between lines, so it is
+         rescanned each line. a template renders again only when a
+         placeholder poll or vln_prompt_update reports a change */
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    if (NULL == vln->ppt.tmpl) {
+        vln->ppt.dirty = 1;
+    }
+#else
+    vln->ppt.dirty = 1;
+#endif
+    vln_prompt_poll(vln);
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+    /*!< enable bracketed paste while editing */
+    vln->ln.paste = 0;
+    vln->ln.ptail = 0;
+    if (vln_profile_get(vln)->esc) {
+        vln_put(vln, "\e[?2004h", 8, -1);
+    }
+#endif
+
+    /*!< output prompt, plain after application output */
+    vln_edit_sgr(vln, 0);
+    vln_put(vln, vln->prompt, vln->ln.pptlen, -1);
+
+    vln->ln.dirty = VLN_OFF_NONE;
+    vln->ln.winoff = 0;
+    vln->ln.drawn = 0;
+    vln->ln.cursor = vln->ln.pptoff;
+
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+    vln->ln.wrap = vln_edit_wraps(vln);
+#endif
+
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+    vln->hl.nspan = 0;
+#endif
+
+#if defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE
+    vln->cpl.out.len = 0;
+    vln->cpl.next = 0;
+#endif
+
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+    vln_undo_reset(vln);
+#endif
+
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    vln->stm.on = 0;
+#endif
+
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+    vln->sug.hit = VLN_OFF_NONE;
+    vln->sug.len = 0;
+    vln->sug.drawn = VLN_OFF_NONE;
+    vln->sug.from = 0;
+    vln->sug.shown = 0;
+#endif
+
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    /*!< output right segment */
+    vln->ppt.shown = 0;
+    if (vln->ppt.rptlen && vln_edit_refresh(vln)) {
+        return -1;
+    }
+#endif
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        finish line, output newline and terminate linebuff
+* 
+* @param[in]    vln         
+* @param[out]   linesize    readline size
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+static int vln_line_end(vln_t *vln, uint32_t *linesize)
+{
+    /*!< newline below the last row of a wrapped line */
+    vln_edit_leave(vln);
+
+    /*!< leave attributes plain for application output */
+    vln_edit_sgr(vln, 0);
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+    if (vln_profile_get(vln)->esc) {
+        vln_put(vln, "\e[?2004l", 8, -1);
+    }
+#endif
+
+    *linesize = vln->ln.buff->size;
+    vln->ln.buff->pbuf[*linesize] = '\0';
+    vln->ln.buff = NULL;
+
+    /*!< new line */
+    vln_put(vln, CFG_VLN_NEWLINE, sizeof(CFG_VLN_NEWLINE) ? sizeof(CFG_VLN_NEWLINE) - 1 : 0, -1);
+
+    return 0;
+}
+
+#if defined(CFG_VLN_HEADLESS) && CFG_VLN_HEADLESS
+
+/** @addtogroup vln_headless
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        find first CR or LF, a word at a time
+* 
+* @param[in]    buf         
+* @param[in]    from        start offset
+* @param[in]    to          end offset
+* 
+* @retval uint16_t          offset of newline, to if none
+*****************************************************************************/
+static uint16_t vln_headless_scan(const char *buf, uint16_t from, uint16_t to)
+{
+    uintptr_t w;
+
+    /*!< memcpy keeps the load legal at any alignment, it compiles to one
+         word load where unaligned loads are allowed */
+    for (; (uint16_t)(to - from) >= sizeof(w); from += sizeof(w)) {
+        memcpy(&w, buf + from, sizeof(w));
+
+        if (VLN_SWAR_ZERO(w ^ (VLN_SWAR_ONES * '\r')) | VLN_SWAR_ZERO(w ^ (VLN_SWAR_ONES * '\n'))) {
+            break;
+        }
+    }
+
+    for (; from < to; from++) {
+        if ((buf[from] == '\r') || (buf[from] == '\n')) {
+            return from;
+        }
+    }
+
+    return to;
+}
+
+/*****************************************************************************
+* @brief        read input in bulk, bytes left in the rx buffer come first
+*****************************************************************************/
+static uint16_t vln_headless_read(vln_t *vln, char *buf, uint16_t size)
+{
+#if defined(CFG_VLN_RXBUF) && CFG_VLN_RXBUF
+    uint16_t n;
+
+    if (vln->rx.off < vln->rx.len) {
+        n = vln->rx.len - vln->rx.off;
+        n = n < size ? n : size;
+        memcpy(buf, vln->rx.pbuf + vln->rx.off, n);
+        vln->rx.off += n;
+        return n;
+    }
+#endif
+
+    return vln->sget(buf, size);
+}
+
+/*****************************************************************************
+* @brief        headless readline, sget fills linebuff directly and lines
+*               are returned from where they arrived, bytes after a line
+*               stay in linebuff for the next call. a line longer than
+*               linebuff is returned cut and the rest of it is dropped,
+*               or streamed if a stream callback is set
+* 
+* @param[in]    vln         
+* @param[in]    linebuff    linebuff pointer
+* @param[in]    buffsize    linebuff size
+* @param[out]   linesize    readline size
+* @param[in]    block       wait in sget until a line completes
+* 
+* @retval char*             line pointer, NULL if input ran dry
+*****************************************************************************/
+static char *vln_headless_line(vln_t *vln, char *linebuff, uint32_t buffsize, uint32_t *linesize, uint8_t block)
+{
+    char *buf = linebuff + sizeof(*vln->ln.buff);
+    uint16_t lnmax = buffsize - 5; /*!< reserved for \0 and size */
+    uint16_t off = vln->hdl.off;
+    uint16_t len = vln->hdl.len;
+    uint16_t scan = vln->hdl.scan;
+    uint16_t end;
+    uint16_t n;
+    char *line;
+
+    /*!< input left in another linebuff */
+    if (buf != vln->hdl.pbuf) {
+        n = len - off;
+        n = n < lnmax ? n : lnmax;
+        if (n) {
+            memmove(buf, vln->hdl.pbuf + off, n);
+        }
+
+        vln->hdl.pbuf = buf;
+        off = 0;
+        len = n;
+        scan = 0;
+    }
+
+    for (;;) {
+        /*!< LF of a CR LF pair */
+        if (vln->hdl.cr && (off < len)) {
+            off += (buf[off] == '\n');
+            vln->hdl.cr = 0;
+        }
+
+        scan = scan < off ? off : scan;
+        end = vln_headless_scan(buf, scan, len);
+
+        if (end < len) {
+            vln->hdl.cr = (buf[end] == '\r');
+
+            if (!vln->hdl.skip) {
+                break;
+            }
+
+            /*!< end of an overlong line */
+            vln->hdl.skip = 0;
+            off = end + 1;
+            scan = off;
+            continue;
+        }
+
+        if (vln->hdl.skip) {
+            off = len = 0;
+        } else if ((uint16_t)(len - off) >= lnmax) {
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+            if (NULL != vln->stm.cb) {
+                /*!< line fills linebuff, hand it over and read on */
+                vln->stm.cb(vln->stm.arg, buf + off, len - off, VLN_STREAM_MORE);
+                vln->stm.on = 1;
+                off = len = scan = 0;
+                continue;
+            }
+#endif
+            /*!< line fills linebuff, take it and drop the rest */
+            vln->hdl.skip = 1;
+            vln->hdl.cr = 0;
+            break;
+        } else if ((len == lnmax) && off) {
+            /*!< room for the rest of the line */
+            memmove(buf, buf + off, len - off);
+            len -= off;
+            off = 0;
+        }
+
+        scan = len;
+
+        n = vln_headless_read(vln, buf + len, lnmax - len);
+        if (0 == n) {
+            if (block) {
+                vln_idle(vln);
+                continue;
+            }
+
+            vln->hdl.off = off;
+            vln->hdl.len = len;
+            vln->hdl.scan = scan;
+            return NULL;
+        }
+
+        len += n;
+    }
+
+    line = buf + off;
+    *linesize = end - off;
+
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    if (vln->stm.on) {
+        /*!< the rest ends the stream, the line itself comes back empty */
+        vln->stm.on = 0;
+        vln->stm.cb(vln->stm.arg, line, *linesize, VLN_STREAM_END);
+        *linesize = 0;
+    }
+#endif
+
+    if (vln->hdl.skip) {
+        /*!< nothing is kept behind a cut line */
+        vln->hdl.off = 0;
+        vln->hdl.len = 0;
+        vln->hdl.scan = 0;
+    } else {
+        vln->hdl.off = end + 1;
+        vln->hdl.len = len;
+        vln->hdl.scan = end + 1;
+    }
+
+#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
+    if (vln_history_enabled(vln) && *linesize) {
+        /*!< history copies from the head of linebuff, input after the
+             line is not touched */
+        if (off) {
+            memmove(buf, line, *linesize);
+            line = buf;
+        }
+
+        vln->ln.buff = (void *)linebuff;
+        vln->ln.buff->size = *linesize;
+        vln->hist.index = 0;
+        vln_history_store(vln);
+        vln->ln.buff = NULL;
+    }
+#endif
+
+    line[*linesize] = '\0';
+
+    return line;
+}
+
+/*---------------------------------------------------------------------------
+* @}            vln_headless
+----------------------------------------------------------------------------*/
+#endif
+
+/*****************************************************************************
+* @brief        readline internal
+* 
+* @param[in]    vln         
+* 
+* @retval char*             line pointer
+*****************************************************************************/
+static char *vln_inernal(vln_t *vln)
+{
+    int ret;
+    uint8_t c = 0;
+
+    while (1) {
+        /*!< get a key, resolve a lone esc while waiting */
+        while (0 == vln_getc(vln, &c)) {
+            ret = vln_seqexpire(vln);
+            if (ret < 0) {
+                return NULL;
+            } else if (ret > 0) {
+                return vln->ln.buff->pbuf;
+            }
+
+            vln_idle(vln);
+
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+            /*!< placeholders may change while no key arrives */
+            if ((0 == vln_prompt_wait(vln)) && vln_prompt_poll(vln) && vln_edit_reprompt(vln)) {
+                return NULL;
+            }
+#endif
+        }
+
+        vln_detect_poll(vln);
+
+        /*!< output prompt again if placeholders changed */
+        if (vln_prompt_poll(vln) && vln_edit_reprompt(vln)) {
+            return NULL;
+        }
+
+        ret = vln_input(vln, c);
+        if (ret < 0) {
+            return NULL;
+        } else if (ret > 0) {
+            return vln->ln.buff->pbuf;
+        }
+    }
+}
+
+/* exported functions ------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        clear screen and refresh line
+*****************************************************************************/
+void vln_clear(vln_t *vln)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    vln_edit_clear(vln);
+}
+
+/*****************************************************************************
+* @brief        enable or disable mask mode
+*****************************************************************************/
+void vln_mask(vln_t *vln, uint8_t mask)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    vln->ln.mask = mask ? 1 : 0;
+
+    if (NULL != vln->ln.buff) {
+        vln->ln.buff->mask = vln->ln.mask;
+        vln_edit_dirty(vln, 0);
+        vln->ln.drawn = VLN_OFF_NONE;
+        vln_edit_refresh(vln);
+    }
+}
+
+/*****************************************************************************
+* @brief        mark prompt changed, a plain prompt is rescanned at the
+*               start of each line anyway, call this after modify prompt
+*               string while a line is being edited, or when a placeholder
+*               value changed without poll callback
+*****************************************************************************/
+void vln_prompt_update(vln_t *vln)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    vln->ppt.dirty = 1;
+}
+
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+/*****************************************************************************
+* @brief        set prompt template, %key is replaced by placeholder render
+*               callback, %% output %, text after %> is right aligned.
+*               rendered bytes and width are cached and recalculated only
+*               when a placeholder poll callback reports a change
+* 
+* @param[in]    vln         
+* @param[in]    tmpl        template string
+* @param[in]    vars        placeholders
+* @param[in]    nvars       placeholder count
+* @param[in]    buf         render buffer, holds two renders, the one on
+*                           screen and the next one to compare with it
+* @param[in]    size        render buffer size, twice the longest prompt
+* 
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+int vln_prompt(vln_t *vln, const char *tmpl, const vln_pptvar_t *vars, uint8_t nvars, char *buf, uint16_t size)
+{
+    VLN_PARAM_CHECK(NULL != vln, -1);
+    VLN_PARAM_CHECK(NULL != tmpl, -1);
+    VLN_PARAM_CHECK(NULL != buf, -1);
+    VLN_PARAM_CHECK(size > 3, -1);
+    VLN_PARAM_CHECK((0 == nvars) || (NULL != vars), -1);
+
+    /*!< one half on screen, the other takes the next render */
+    buf[0] = '\0';
+    vln->ppt.tmpl = tmpl;
+    vln->ppt.vars = vars;
+    vln->ppt.nvars = nvars;
+    vln->ppt.pbuf = buf + size / 2;
+    vln->ppt.size = size / 2;
+    vln->ppt.rptlen = 0;
+    vln->ppt.rptoff = 0;
+    vln->ppt.dirty = 1;
+    vln->ppt.tick = (NULL != vln->tick) ? vln->tick() : 0;
+    vln->prompt = buf;
+    vln->ln.pptlen = 0;
+    vln->ln.pptoff = 0;
+
+    return 0;
+}
+#endif
+
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+/*****************************************************************************
+* @brief        set highlight callback, called with the changed region on 
+*               each refresh, attributes are sent only where spans differ
+*               from the screen
+* 
+* @param[in]    vln         
+* @param[in]    cb          highlight callback, NULL to disable
+* @param[in]    arg         callback argument
+*****************************************************************************/
+void vln_highlight(vln_t *vln, vln_highlight_t cb, void *arg)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    vln->hl.cb = cb;
+    vln->hl.arg = arg;
+    vln->hl.nspan = 0;
+
+    if (NULL != vln->ln.buff) {
+        vln_edit_dirty(vln, 0);
+        vln_edit_refresh(vln);
+    }
+}
+#endif
+
+#if defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE
+/*****************************************************************************
+* @brief        set completion callback, tab completes the word before the
+*               cursor as far as all candidates agree and lists them when
+*               that adds nothing
+* 
+* @param[in]    vln         
+* @param[in]    cb          completion callback, NULL to disable
+* @param[in]    arg         callback argument
+* @param[in]    buf         listing buffer, a page that fits is sent by one
+*                           sput, NULL sends each piece on its own
+* @param[in]    size        buffer size
+*****************************************************************************/
+void vln_complete(vln_t *vln, vln_complete_t cb, void *arg, char *buf, uint16_t size)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    vln->cpl.cb = cb;
+    vln->cpl.arg = arg;
+    vln->cpl.out.pbuf = buf;
+    vln->cpl.out.size = (NULL != buf) ? size : 0;
+    vln->cpl.out.len = 0;
+    vln->cpl.next = 0;
+}
+#endif
+
+#if defined(CFG_VLN_FRAME) && CFG_VLN_FRAME
+/*****************************************************************************
+* @brief        set frame callback, requests framed as ESC _ V are then taken
+*               out of the input wherever they arrive and answered with one
+*               sput, without echo and without touching the line
+* 
+*               ESC _ V | type | tag | length | payload | crc | ESC \
+* 
+*               type is 'q' for a request, 'r' for a response and 'e' for
+*               an error with a VLN_FRAME_E* code as payload. tag is sent
+*               back as it came. length and crc are 2 bytes, big endian,
+*               crc is CRC-16/CCITT-FALSE from type to the payload end
+* 
+* @param[in]    vln         
+* @param[in]    cb          frame callback, NULL to take ESC _ as a key
+* @param[in]    arg         callback argument
+* @param[in]    buf         frame buffer, a request and its response
+* @param[in]    size        buffer size, payload up to size - 
+*                           VLN_FRAME_OVERHEAD
+*****************************************************************************/
+void vln_frame(vln_t *vln, vln_frame_t cb, void *arg, char *buf, uint16_t size)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+    VLN_PARAM_CHECK((NULL == cb) || ((NULL != buf) && (size > VLN_FRAME_OVERHEAD)), );
+
+    /*!< a frame cut by the change must not leak into the line */
+    if ((VLN_SEQ_APC == vln->seq.state) || (VLN_SEQ_FRAME == vln->seq.state)) {
+        vln->seq.state = VLN_SEQ_NONE;
+    }
+
+    vln->frm.cb = cb;
+    vln->frm.arg = arg;
+    vln->frm.pbuf = (uint8_t *)buf;
+    vln->frm.size = size;
+}
+#endif
+
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+/*****************************************************************************
+* @brief        set stream callback, a line that outgrows linebuff is then
+*               handed over a linebuff at a time instead of being cut. the
+*               line returns empty once entered, the callback has all of it
+*               and is told the end. set between two lines
+* 
+* @param[in]    vln         
+* @param[in]    cb          stream callback, NULL to cut long lines
+* @param[in]    arg         callback argument
+*****************************************************************************/
+void vln_stream(vln_t *vln, vln_stream_t cb, void *arg)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    vln->stm.cb = cb;
+    vln->stm.arg = arg;
+}
+#endif
+
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+/*****************************************************************************
+* @brief        page long output between two lines. output that fits one
+*               screen is printed as it is. longer output is shown on the
+*               alternate screen, and the next vln() or vln_isr() calls take
+*               the pager keys until q, the prompt comes back after that.
+*               lines are pulled from cb as they are shown, nothing is kept
+* 
+*               space f pgdn    next page       b pgup      previous page
+*               enter j down    next line       k up        previous line
+*               d u             half page       g G         first, last page
+*               / n N           search, next, previous      q ctrl-c quit
+* 
+* @param[in]    vln         
+* @param[in]    cb          source of output lines
+* @param[in]    arg         callback argument
+* @param[in]    buf         output buffer, a page that fits is sent by one
+*                           sput, NULL sends each piece on its own
+* @param[in]    size        buffer size
+* 
+* @retval int               0:Success -1:Error, or a line is being edited
+*****************************************************************************/
+int vln_pager(vln_t *vln, vln_pager_t cb, void *arg, char *buf, uint16_t size)
+{
+    uint16_t rows;
+    uint16_t n;
+    int ret;
+    VLN_PARAM_CHECK(NULL != vln, -1);
+    VLN_PARAM_CHECK(NULL != cb, -1);
+
+    if ((NULL != vln->ln.buff) || (NULL != vln->pgr.cb)) {
+        return -1;
+    }
+
+    rows = vln_pager_rows(vln);
+
+    vln->pgr.cb = cb;
+    vln->pgr.arg = arg;
+    vln->pgr.out.pbuf = buf;
+    vln->pgr.out.size = (NULL != buf) ? size : 0;
+    vln->pgr.out.len = 0;
+    vln->pgr.top = 0;
+    vln->pgr.end = UINT32_MAX;
+    vln->pgr.rows = 0;
+    vln->pgr.scr = vln_profile_get(vln)->esc && (vln->term.row > 2);
+    vln->pgr.find = 0;
+    vln->pgr.miss = 0;
+    vln->pgr.plen = 0;
+    vln->pgr.slen = 0;
+
+    if (NULL == vln_pager_line(vln, rows, &n)) {
+        /*!< one screen or less needs no paging */
+        ret = vln_pager_lines(vln, 0, rows, 1);
+        vln->pgr.cb = NULL;
+    } else if (vln->pgr.scr) {
+        /*!< 1.save cursor                   <esc>7     */
+        /*!< 2.enter alternate screen buffer <esc>[?47h */
+        ret = (!vln->term.alt && vln_stage_emit(vln, &vln->pgr.out, "\e7\e[?47h", 8)) ||
+              vln_pager_show(vln, 0, 1);
+    } else {
+        ret = vln_pager_show(vln, 0, 1);
+    }
+
+    if (ret || vln_stage_flush(vln, &vln->pgr.out)) {
+        vln->pgr.cb = NULL;
+        vln->pgr.out.len = 0;
+        return -1;
+    }
+
+    return 0;
+}
+#endif
+
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+/*****************************************************************************
+* @brief        keep a status row on the bottom terminal row, call between
+*               two lines. the rows above it become a DECSTBM scroll region
+*               and term.row counts only them, so output, the prompt, the
+*               pager and completion scroll above the status row. needs a
+*               profile with esc and at least 3 rows
+* 
+* @param[in]    vln         
+* @param[in]    buf         cells shown and cells to show, half of the
+*                           buffer each, NULL gives the row back
+* @param[in]    size        buffer size, twice the status width
+* 
+* @retval int               0:Success -1:Error, or a line is being edited
+*****************************************************************************/
+int vln_status(vln_t *vln, char *buf, uint16_t size)
+{
+    uint8_t seq[48];
+    size_t idx = 0;
+    VLN_PARAM_CHECK(NULL != vln, -1);
+
+    if (NULL != vln->ln.buff) {
+        return -1;
+    }
+
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+    if (NULL != vln->pgr.cb) {
+        return -1;
+    }
+#endif
+
+    if (NULL != vln->sts.shown) {
+        vln->term.row = vln->sts.row;
+        vln->sts.shown = NULL;
+
+        if (NULL == buf) {
+            /*!< 1.whole screen scrolls again   <esc>[r     */
+            /*!< 2.clear status row plain       <esc>[m<esc>[K */
+            seq[idx++] = '\e';
+            seq[idx++] = '7';
+            vln_seqgen_csi0(seq, &idx, 'r');
+            vln_seqgen_cursor_position(seq, &idx, vln->term.row, 1);
+            vln_seqgen_csi0(seq, &idx, 'm');
+            vln_seqgen_csi0(seq, &idx, 'K');
+            seq[idx++] = '\e';
+            seq[idx++] = '8';
+            vln_put(vln, seq, idx, -1);
+        }
+    }
+
+    if (NULL == buf) {
+        return 0;
+    }
+
+    if ((size < 2) || !vln_profile_get(vln)->esc || (vln->term.row < 3)) {
+        return -1;
+    }
+
+    vln->sts.width = size / 2;
+    vln->sts.shown = buf;
+    vln->sts.next = buf + vln->sts.width;
+    vln->sts.row = vln->term.row;
+    vln->term.row -= 1;
+    memset(vln->sts.shown, ' ', vln->sts.width);
+    memset(vln->sts.next, ' ', vln->sts.width);
+    vln->sts.dirty = 0;
+    vln->sts.tick = (NULL != vln->tick) ? vln->tick() - CFG_VLN_STATUS_INTERVAL : 0;
+
+    /*!< 1.keep the cursor row off the last row  \n<esc>[A */
+    /*!< 2.save cursor, DECSTBM homes it        <esc>7     */
+    /*!< 3.rows above status scroll             <esc>[1;nr */
+    /*!< 4.clear status row plain, no line sgr  <esc>[m<esc>[K */
+    /*!< 5.restore cursor and sgr               <esc>8     */
+    seq[idx++] = '\n';
+    vln_seqgen_csi0(seq, &idx, 'A');
+    seq[idx++] = '\e';
+    seq[idx++] = '7';
+    vln_seqgen_csi2(seq, &idx, 'r', 1, vln->term.row);
+    vln_seqgen_cursor_position(seq, &idx, vln->sts.row, 1);
+    vln_seqgen_csi0(seq, &idx, 'm');
+    vln_seqgen_csi0(seq, &idx, 'K');
+    seq[idx++] = '\e';
+    seq[idx++] = '8';
+    vln_put(vln, seq, idx, -1);
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        change the status text. cells that differ from the screen
+*               are sent at once, or within CFG_VLN_STATUS_INTERVAL ms of
+*               the last change from vln(), vln_isr() or the wait callback,
+*               so only the latest text of a burst is drawn. vln_timeout()
+*               covers a held change. call from the thread running vln(),
+*               the wait callback may call it while vln() waits for a key
+* 
+* @param[in]    vln         
+* @param[in]    text        one byte per cell, bytes other than printable
+*                           ascii show as space, cut to the status width
+* @param[in]    len         text size, cells after it are spaces
+* 
+* @retval int               0:Success -1:Error, or no status row
+*****************************************************************************/
+int vln_status_update(vln_t *vln, const char *text, uint16_t len)
+{
+    uint16_t i;
+    uint8_t c;
+    VLN_PARAM_CHECK(NULL != vln, -1);
+    VLN_PARAM_CHECK((NULL != text) || (0 == len), -1);
+
+    if (NULL == vln->sts.shown) {
+        return -1;
+    }
 
-            /*!< move home */
-            case VLN_EXEC_MVHM:
-                if (vln_edit_movehome(vln)) {
-                    return NULL;
-                }
-                break;
+    for (i = 0; i < vln->sts.width; i++) {
+        c = (i < len) ? (uint8_t)text[i] : ' ';
+        vln->sts.next[i] = ((c < 0x20) || (c > 0x7e)) ? ' ' : (char)c;
+    }
 
-            /*!< fetch next history */
-            case VLN_EXEC_NXTH:
-#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
-                if (vln_history_loadnext(vln)) {
-                    return NULL;
-                }
-#endif
-                break;
+    vln->sts.dirty = (0 != memcmp(vln->sts.next, vln->sts.shown, vln->sts.width));
 
-            /*!< fetch prev history */
-            case VLN_EXEC_PRVH:
-#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
-                if (vln_history_loadprev(vln)) {
-                    return NULL;
-                }
+    return vln_status_poll(vln);
+}
 #endif
-                break;
-
-            /*!< delete prev word */
-            case VLN_EXEC_DLWD:
-                if (vln_edit_delword(vln)) {
-                    return NULL;
-                }
-                break;
-
-            /*!< delete whole line */
-            case VLN_EXEC_DHLN:
-                if (vln_edit_delline(vln)) {
-                    return NULL;
-                }
-                break;
-
-            /*!< delete cursor to end */
-            case VLN_EXEC_DELN:
-                if (vln_edit_delend(vln)) {
-                    return NULL;
-                }
-                break;
 
-            /*!< list completions */
-            case VLN_EXEC_SCPT:
-                break;
+/*****************************************************************************
+* @brief        Fill Character Attributes SGR set to sgrraw, colours are sent
+*               as given and fields left 0 are not changed
+* 
+* @param[in]    buf         buffer for fill, VLN_SGR_MAX bytes after idx
+* @param[in]    idx         pointer to buffer index
+* @param[in]    sgrraw      sgr attributes, 0 to reset
+* 
+*****************************************************************************/
+void vln_sgrset(char *buf, size_t *idx, uint64_t sgrraw)
+{
+    vln_sgr_t none = { .raw = 0 };
+    size_t start;
 
-            /*!< auto complete */
-            case VLN_EXEC_ACPT:
-                break;
+    vln_seqgen_csi((void *)buf, idx);
+    start = *idx;
 
-            /*!< switch to normal screen */
-            case VLN_EXEC_SWNM:
-#if defined(CFG_VLN_XTERM) && CFG_VLN_XTERM
-                if (vln->term.nsupt == 0) {
-                    vln_put(vln, "\e[?47l", 6, NULL);
-                    vln->term.alt = 0;
-                }
-#endif
-                break;
+    vln_sgr_params((void *)buf, idx, none, (vln_sgr_t){ .raw = sgrraw });
 
-            case VLN_EXEC_HELP:
-                if (vln_help(vln)) {
-                    return NULL;
-                }
-                vln->ln.buff->size = 0;
-                return vln->ln.buff->pbuf;
-        }
+    if (*idx == start) {
+        buf[(*idx)++] = 'm';
+    } else {
+        buf[(*idx) - 1] = 'm';
     }
-}
 
-/* exported functions ------------------------------------------------------*/
+    buf[*idx] = '\0';
+}
 
 /*****************************************************************************
-* @brief        clear screen and refresh line
+* @brief        Fill SGR that changes the session attributes to sgrraw, only
+*               the changed ones, or a reset when that is shorter, nothing
+*               when unchanged or on a dumb terminal. colours the terminal
+*               lacks are sent as the nearest it has. write the result
+*               before the next vln call, which counts on the same state
+* 
+* @param[in]    vln         
+* @param[in]    buf         buffer for fill, VLN_SGR_MAX bytes after idx
+* @param[in]    idx         pointer to buffer index
+* @param[in]    sgrraw      sgr attributes, 0 to reset
+* 
 *****************************************************************************/
-void vln_clear(vln_t *vln)
+void vln_sgrdelta(vln_t *vln, char *buf, size_t *idx, uint64_t sgrraw)
 {
     VLN_PARAM_CHECK(NULL != vln, );
+    VLN_PARAM_CHECK(NULL != buf, );
+    VLN_PARAM_CHECK(NULL != idx, );
 
-    vln_edit_clear(vln);
+    vln_sgr_update(vln, (void *)buf, idx, sgrraw);
+    buf[*idx] = '\0';
 }
 
 /*****************************************************************************
-* @brief        enable or disable mask mode
+* @brief        set colours the terminal shows, fewer are approximated
+* 
+* @param[in]    vln         
+* @param[in]    colors      VLN_COLORS_8, VLN_COLORS_256 or VLN_COLORS_TRUE,
+*                           VLN_COLORS_AUTO for the profile
 *****************************************************************************/
-void vln_mask(vln_t *vln, uint8_t mask)
+void vln_colors(vln_t *vln, uint8_t colors)
 {
     VLN_PARAM_CHECK(NULL != vln, );
 
-    vln->ln.mask = mask ? 1 : 0;
-
-    if (NULL != vln->ln.buff) {
-        vln->ln.buff->mask = vln->ln.mask;
-        vln_edit_refresh(vln);
-    }
+    vln->sgr.colors = (colors > VLN_COLORS_TRUE) ? VLN_COLORS_AUTO : colors;
 }
 
 /*****************************************************************************
-* @brief        Fill Character Attributes SGR set to sgrraw
+* @brief        readline
 * 
-* @param[in]    buf         buffer for fill
-* @param[in]    idx         pointer to buffer index
-* @param[in]    sgrraw      sgr attributes, 0 to reset
+* @param[in]    vln         
+* @param[in]    linebuff    linebuff pointer
+* @param[in]    buffsize    linebuff size
+* @param[in]    linesize    readline size
 * 
+* @retval char*             line pointer
 *****************************************************************************/
-void vln_sgrset(char *buf, size_t *idx, uint16_t sgrraw)
+char *vln(vln_t *vln, char *linebuff, uint32_t buffsize, uint32_t *linesize)
 {
-    vln_sgr_t sgr = { .raw = sgrraw };
-    vln_seqgen_csi((void *)buf, idx);
-
-    if (sgrraw == 0) {
-        buf[(*idx)++] = 'm';
-        buf[*idx] = '\0';
-        return;
-    }
-
-    if (sgr.bold) {
-        buf[(*idx) + 0] = '1';
-        buf[(*idx) + 1] = ';';
-        (*idx) += 2;
-    }
+    char *ret = NULL;
+    VLN_PARAM_CHECK(NULL != vln, NULL);
+    VLN_PARAM_CHECK(NULL != linebuff, NULL);
+    VLN_PARAM_CHECK(buffsize > 5, NULL);
+    VLN_PARAM_CHECK(NULL != linesize, NULL);
 
-    if (sgr.underline) {
-        buf[(*idx) + 0] = '4';
-        buf[(*idx) + 1] = ';';
-        (*idx) += 2;
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+    /*!< prompt waits until the pager is closed */
+    if (vln_pager_run(vln, 1)) {
+        *linesize = 0;
+        return NULL;
     }
+#endif
 
-    if (sgr.blink) {
-        buf[(*idx) + 0] = '5';
-        buf[(*idx) + 1] = ';';
-        (*idx) += 2;
+#if defined(CFG_VLN_HEADLESS) && CFG_VLN_HEADLESS
+    if (VLN_HEADLESS_ON == vln->hdl.mode) {
+        return vln_headless_line(vln, linebuff, buffsize, linesize, 1);
     }
+#endif
 
-    if (sgr.inverse) {
-        buf[(*idx) + 0] = '8';
-        buf[(*idx) + 1] = ';';
-        (*idx) += 2;
+#if defined(CFG_VLN_XTERM) && CFG_VLN_XTERM
+    /*!< wait switch to altscreen */
+    if (vln->term.altnsupt == 0) {
+        vln_wait_altscreen(vln);
     }
+#endif
 
-    if (sgr.foreground) {
-        buf[(*idx) + 0] = '3';
-        buf[(*idx) + 1] = '0' + (sgr.foreground - 1);
-        buf[(*idx) + 2] = ';';
-        (*idx) += 3;
+    if (0 == vln_line_begin(vln, linebuff, buffsize)) {
+        ret = vln_inernal(vln);
     }
 
-    if (sgr.background) {
-        buf[(*idx) + 0] = '4';
-        buf[(*idx) + 1] = '0' + (sgr.background - 1);
-        buf[(*idx) + 2] = ';';
-        (*idx) += 3;
-    }
+    vln_line_end(vln, linesize);
 
-    buf[(*idx) - 1] = 'm';
-    buf[*idx] = '\0';
+    return ret;
 }
 
 /*****************************************************************************
-* @brief        readline
+* @brief        readline without blocking, reads every byte sget has ready
+*               and returns as soon as sget runs dry or the line completes.
+*               the first call starts a line and outputs prompt, pass the
+*               same linebuff until a line is returned, the escape parser
+*               state is kept in vln so sget may stop anywhere. with a tick
+*               callback, call it again once vln_timeout ms pass without
+*               input so a lone esc resolves after CFG_VLN_ESC_TIMEOUT
 * 
 * @param[in]    vln         
 * @param[in]    linebuff    linebuff pointer
 * @param[in]    buffsize    linebuff size
 * @param[in]    linesize    readline size
 * 
-* @retval char*             line pointer
+* @retval char*             line pointer, NULL if line is not complete
+*                           or dropped on output error
 *****************************************************************************/
-char *vln(vln_t *vln, char *linebuff, uint32_t buffsize, uint32_t *linesize)
+char *vln_isr(vln_t *vln, char *linebuff, uint32_t buffsize, uint32_t *linesize)
 {
-    char *ret;
+    char *line;
+    int ret = 0;
+    uint8_t c;
     VLN_PARAM_CHECK(NULL != vln, NULL);
     VLN_PARAM_CHECK(NULL != linebuff, NULL);
     VLN_PARAM_CHECK(buffsize > 5, NULL);
     VLN_PARAM_CHECK(NULL != linesize, NULL);
 
-    vln->ln.buff = (void *)linebuff;
-    vln->ln.buff->size = 0;
-    vln->ln.buff->mask = vln->ln.mask;
-    vln->ln.lnmax = buffsize - 5; /*!< reserved for \0 and size */
-    vln->ln.curoff = 0;
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+    /*!< prompt waits until the pager is closed */
+    if ((NULL == vln->ln.buff) && vln_pager_run(vln, 0)) {
+        return NULL;
+    }
+#endif
 
-#if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
-    vln->hist.index = 0;
+#if defined(CFG_VLN_HEADLESS) && CFG_VLN_HEADLESS
+    /*!< mode changes take effect between lines */
+    if ((VLN_HEADLESS_ON == vln->hdl.mode) && (NULL == vln->ln.buff)) {
+        return vln_headless_line(vln, linebuff, buffsize, linesize, 0);
+    }
 #endif
 
-    /*!< calculate prompt offset and size */
-    vln_calculate_prompt(vln);
+    if (NULL == vln->ln.buff) {
+        if (vln_line_begin(vln, linebuff, buffsize)) {
+            ret = -1;
+        }
+    }
 
-    ret = vln_inernal(vln);
+    vln_detect_poll(vln);
 
-    /*!< new line */
-    vln_put(vln, CFG_VLN_NEWLINE, sizeof(CFG_VLN_NEWLINE) ? sizeof(CFG_VLN_NEWLINE) - 1 : 0, NULL);
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    if ((ret == 0) && vln_status_poll(vln)) {
+        ret = -1;
+    }
+#endif
 
-    *linesize = vln->ln.buff->size;
-    vln->ln.buff->pbuf[*linesize] = '\0';
-    vln->ln.buff = NULL;
+    /*!< output prompt again if placeholders changed */
+    if ((ret == 0) && vln_prompt_poll(vln) && vln_edit_reprompt(vln)) {
+        ret = -1;
+    }
 
-    return ret;
+    while ((ret == 0) && vln_getc(vln, &c)) {
+        ret = vln_input(vln, c);
+    }
+
+    /*!< input ran dry, a lone esc may have timed out */
+    if (ret == 0) {
+        ret = vln_seqexpire(vln);
+    }
+
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    /*!< status held back by the interval while keys came in */
+    if ((ret == 0) && vln_status_poll(vln)) {
+        ret = -1;
+    }
+#endif
+
+    if (ret == 0) {
+        return NULL;
+    }
+
+    line = (ret > 0) ? vln->ln.buff->pbuf : NULL;
+    vln_line_end(vln, linesize);
+
+    return line;
 }
 
 /*****************************************************************************
@@ -1583,57 +6495,336 @@ int vln_init(vln_t *vln, vln_init_t *init)
     VLN_PARAM_CHECK(NULL != init->sget, -1);
     VLN_PARAM_CHECK(NULL != init->sput, -1);
     VLN_PARAM_CHECK(NULL != init->prompt, -1);
-    VLN_PARAM_CHECK(NULL != init->history, -1);
-    VLN_PARAM_CHECK(!((init->histsize < 2) ||
-                      (init->histsize & (init->histsize - 1))),
+    VLN_PARAM_CHECK((NULL == init->history) ||
+                        !((init->histsize < 2) || (init->histsize & (init->histsize - 1))),
                     -1);
 
     vln->prompt = init->prompt;
+    vln->ppt.dirty = 1;
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    vln->ppt.tmpl = NULL;
+    vln->ppt.nvars = 0;
+    vln->ppt.rptlen = 0;
+    vln->ppt.rptoff = 0;
+#endif
     vln->sget = init->sget;
+    vln->seq.state = VLN_SEQ_NONE;
+
+#if defined(CFG_VLN_RXBUF) && CFG_VLN_RXBUF
+    vln->rx.off = 0;
+    vln->rx.len = 0;
+#endif
     vln->sput = init->sput;
+    vln->tick = init->tick;
+    vln->wait = init->wait;
 
 #if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
     vln->hist.pbuf = init->history;
     vln->hist.in = 0;
     vln->hist.out = 0;
-    vln->hist.mask = init->histsize - 1;
-    vln->hist.size = init->histsize;
+    vln->hist.mask = (NULL != init->history) ? init->histsize - 1 : 0;
+    vln->hist.size = (NULL != init->history) ? init->histsize : 0;
     vln->hist.cache = 0;
 #endif
 
+#if defined(CFG_VLN_SHARE) && CFG_VLN_SHARE
+    vln->hist.share = init->share;
+    vln->hist.seq = 0;
+#endif
+
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+    VLN_PARAM_CHECK((NULL == init->histidx) ||
+                        !((init->idxsize < 2) || (init->idxsize & (init->idxsize - 1))),
+                    -1);
+
+    vln->sug.pidx = init->histidx;
+    vln->sug.in = 0;
+    vln->sug.out = 0;
+    vln->sug.mask = init->idxsize - 1;
+    vln->sug.lo = 0;
+    vln->sug.hi = 0;
+#endif
+
     vln->term.nsupt = 1;
     vln->term.alt = 0;
     vln->term.row = CFG_VLN_DEFROW;
     vln->term.col = CFG_VLN_DEFCOL;
+    vln->term.type = VLN_TERM_UNKNOWN;
+    vln->term.detect = 0;
+
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+    vln->hl.cb = NULL;
+    vln->hl.nspan = 0;
+#endif
+
+    vln->sgr.cur = 0;
+    vln->sgr.colors = VLN_COLORS_AUTO;
+
+#if defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE
+    vln->cpl.cb = NULL;
+    vln->cpl.out.pbuf = NULL;
+    vln->cpl.out.size = 0;
+    vln->cpl.out.len = 0;
+    vln->cpl.next = 0;
+#endif
+
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+    vln->pgr.cb = NULL;
+    vln->pgr.out.len = 0;
+#endif
+
+#if defined(CFG_VLN_FRAME) && CFG_VLN_FRAME
+    vln->frm.cb = NULL;
+#endif
+
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    vln->stm.cb = NULL;
+    vln->stm.on = 0;
+#endif
+
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    vln->sts.shown = NULL;
+    vln->sts.dirty = 0;
+#endif
 
     vln->ln.buff = NULL;
+    vln->ln.mask = 0;
+
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+    vln->undo.pbuf = (uint8_t *)init->undo;
+    vln->undo.size = (NULL != init->undo) ? init->undosize : 0;
+    vln_undo_reset(vln);
+#endif
+
+#if defined(CFG_VLN_HEADLESS) && CFG_VLN_HEADLESS
+    vln->hdl.mode = VLN_HEADLESS_OFF;
+    vln->hdl.cr = 0;
+    vln->hdl.skip = 0;
+    vln->hdl.pbuf = NULL;
+    vln->hdl.off = 0;
+    vln->hdl.len = 0;
+    vln->hdl.scan = 0;
+#endif
+
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+    vln->probe.cycles = NULL;
+    vln->probe.child = 0;
+#endif
 
     return 0;
 }
 
 /*****************************************************************************
-* @brief        detects if it is xterm, result will be processed automatically
-*               if not xterm it will be blocked on next character
+* @brief        detect terminal type and size without blocking, the replies
+*               are parsed by the input path of vln() whenever they arrive,
+*               the terminal is treated as dumb if the device attributes
+*               reply is not received within CFG_VLN_DETECT_TIMEOUT ms
 * 
 * @param[in]    vln         
 *****************************************************************************/
 void vln_detect(vln_t *vln)
 {
-    uint8_t c;
-    uint16_t pn[4];
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    /*!< 1.report text area size         <esc>[18t             */
+    /*!< 2.save cursor                   <esc>7                */
+    /*!< 3.move cursor to bottom right   <esc>[999;999H        */
+    /*!< 4.report cursor position        <esc>[6n              */
+    /*!< 5.restore cursor                <esc>8                */
+    /*!< 6.primary device attributes     <esc>[c, replied last */
+    if (26 != vln->sput("\e[18t\e7\e[999;999H\e[6n\e8\e[c", 26)) {
+        return;
+    }
+
+    vln->term.type = VLN_TERM_UNKNOWN;
+    vln->term.detect = 1;
+    vln->term.dtick = (NULL != vln->tick) ? vln->tick() : 0;
+}
+
+/*****************************************************************************
+* @brief        ms until vln has work to do without input: a lone esc or a
+*               partial sequence to resolve, terminal detection to give
+*               up, or prompt placeholders to poll. this is the timeout
+*               passed to the wait callback, and the one an event loop
+*               driving vln_isr should sleep for
+* 
+* @param[in]    vln         
+* 
+* @retval uint32_t          timeout in ms, VLN_WAIT_FOREVER if only input
+*                           can wake vln
+*****************************************************************************/
+uint32_t vln_timeout(vln_t *vln)
+{
+    uint32_t ms = VLN_WAIT_FOREVER;
+    uint32_t now, past;
+    VLN_PARAM_CHECK(NULL != vln, VLN_WAIT_FOREVER);
+
+    /*!< without a tick nothing times out */
+    if (NULL == vln->tick) {
+        return ms;
+    }
+
+    now = vln->tick();
+
+    if (VLN_SEQ_NONE != vln->seq.state) {
+        past = now - vln->seq.tick;
+        ms = (past < vln_seqtimeout(vln)) ? vln_seqtimeout(vln) - past : 0;
+    }
+
+    if (vln->term.detect) {
+        past = now - vln->term.dtick;
+        past = (past < CFG_VLN_DETECT_TIMEOUT) ? CFG_VLN_DETECT_TIMEOUT - past : 0;
+        ms = (past < ms) ? past : ms;
+    }
+
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+    if (vln->ln.paste) {
+        past = now - vln->ln.ptick;
+        past = (past < CFG_VLN_PASTE_TIMEOUT) ? CFG_VLN_PASTE_TIMEOUT - past : 0;
+        ms = (past < ms) ? past : ms;
+    }
+#endif
+
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+    if (NULL != vln->ln.buff) {
+        past = vln_prompt_wait(vln);
+        ms = (past < ms) ? past : ms;
+    }
+#endif
+
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    if (vln_status_held(vln)) {
+        past = now - vln->sts.tick;
+        past = (past < CFG_VLN_STATUS_INTERVAL) ? CFG_VLN_STATUS_INTERVAL - past : 0;
+        ms = (past < ms) ? past : ms;
+    }
+#endif
+
+    return ms;
+}
+
+/*****************************************************************************
+* @brief        set output profile, for a terminal known without detection
+* 
+* @param[in]    vln         
+* @param[in]    type        VLN_TERM_DUMB, VLN_TERM_VT100 or VLN_TERM_XTERM,
+*                           VLN_TERM_UNKNOWN for CFG_VLN_TERM
+*****************************************************************************/
+void vln_term(vln_t *vln, uint8_t type)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    vln->term.type = type;
+    vln->term.detect = 0;
+}
+
+#if defined(CFG_VLN_HEADLESS) && CFG_VLN_HEADLESS
+/*****************************************************************************
+* @brief        set headless mode, lines are then split from bulk input
+*               without echo, rendering or key handling, history and the
+*               linebuff limit still apply. input already taken into
+*               linebuff is only read again in headless mode
+* 
+* @param[in]    vln         
+* @param[in]    mode        VLN_HEADLESS_OFF, VLN_HEADLESS_ON, or
+*                           VLN_HEADLESS_AUTO to turn on when vln_detect
+*                           gets no reply
+*****************************************************************************/
+void vln_headless(vln_t *vln, uint8_t mode)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    vln->hdl.mode = mode;
+}
+#endif
+
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+/*****************************************************************************
+* @brief        start probes with a cycle counter and clear histograms,
+*               DWT->CYCCNT on cortex-m or rdtsc on x86
+* 
+* @param[in]    vln         
+* @param[in]    cycles      free running 32bit cycle counter, NULL to stop
+*****************************************************************************/
+void vln_probe(vln_t *vln, uint32_t (*cycles)(void))
+{
+    VLN_PARAM_CHECK(NULL != vln, );
+
+    memset(vln->probe.hist, 0, sizeof(vln->probe.hist));
+    vln->probe.child = 0;
+    vln->probe.cycles = cycles;
+}
+
+/*****************************************************************************
+* @brief        histogram of one stage, bucket n counts spans of 2^n up to
+*               2^(n+1)-1 cycles, bucket 0 also counts 0
+* 
+* @param[in]    vln         
+* @param[in]    stage       VLN_PROBE_PARSE ... VLN_PROBE_OUTPUT
+* 
+* @retval const uint32_t*   CFG_VLN_PROBE_BUCKETS counts, NULL if no stage
+*****************************************************************************/
+const uint32_t *vln_probe_hist(vln_t *vln, uint8_t stage)
+{
+    VLN_PARAM_CHECK(NULL != vln, NULL);
+
+    if (stage >= VLN_PROBE_MAX) {
+        return NULL;
+    }
+
+    return vln->probe.hist[stage];
+}
+#endif
+
+/*****************************************************************************
+* @brief        update terminal size and refresh line if editing
+* 
+* @param[in]    vln         
+* @param[in]    row         terminal rows
+* @param[in]    col         terminal columns
+*****************************************************************************/
+void vln_resize(vln_t *vln, uint16_t row, uint16_t col)
+{
+    VLN_PARAM_CHECK(NULL != vln, );
 
-    /*!< test sput and get screen size */
-    if (5 != vln->sput("\e[18t", 5)) {
+    if ((row == 0) || (col == 0)) {
         return;
     }
 
-    vln_waitkey(vln, &c);
+    /*!< rows of a wrapped line are counted with the old width */
+    if (NULL != vln->ln.buff) {
+        vln_edit_home(vln);
+    }
+
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    /*!< the status row is not counted, term.row is the scroll region */
+    if (NULL != vln->sts.shown) {
+        vln->sts.row = row;
+        row = (row > 2) ? row - 1 : row;
+    }
+#endif
+
+    vln->term.row = row;
+    vln->term.col = col;
+
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    if ((NULL != vln->sts.shown) && vln_status_region(vln)) {
+        return;
+    }
+#endif
 
-    if (c == VLN_C0_ESC) {
-        /*!< execute sequence */
-        if (vln_seqexec(vln, &c, pn)) {
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+    /*!< scroll region is set again for the new height */
+    if (NULL != vln->pgr.cb) {
+        if (vln_pager_show(vln, vln->pgr.top, 1) || vln_stage_flush(vln, &vln->pgr.out)) {
+            vln->pgr.out.len = 0;
         }
+        return;
     }
+#endif
+
+    vln_edit_invalidate(vln);
+    vln_edit_refresh(vln);
 }
 
 /************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
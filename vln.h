@@ -28,6 +28,7 @@ extern "C" {
 #define __vln_h__
 
 /* includes ----------------------------------------------------------------*/
+#include <stddef.h>
 #include <stdint.h>
 
 #include "vln_keycode.h"
@@ -57,10 +58,163 @@ extern "C" {
 #define CFG_VLN_HISTORY 1
 #endif
 
+#ifndef CFG_VLN_PROMPT
+#define CFG_VLN_PROMPT 0
+#endif
+
+/*!< ms between two placeholder polls while idle, needs a tick */
+#ifndef CFG_VLN_PROMPT_POLL
+#define CFG_VLN_PROMPT_POLL 100
+#endif
+
+#ifndef CFG_VLN_HIGHLIGHT
+#define CFG_VLN_HIGHLIGHT 0
+#endif
+
+#ifndef CFG_VLN_HLSPAN
+#define CFG_VLN_HLSPAN 16
+#endif
+
+#ifndef CFG_VLN_SUGGEST
+#define CFG_VLN_SUGGEST 0
+#endif
+
+/*!< suggestions come from history */
+#if !(defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY)
+#undef CFG_VLN_SUGGEST
+#define CFG_VLN_SUGGEST 0
+#endif
+
+/*!< history shared by sessions through a vln_share log, needs vln_share.c */
+#ifndef CFG_VLN_SHARE
+#define CFG_VLN_SHARE 0
+#endif
+
+#if !(defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY)
+#undef CFG_VLN_SHARE
+#define CFG_VLN_SHARE 0
+#endif
+
 #ifndef CFG_VLN_XTERM
 #define CFG_VLN_XTERM 0
 #endif
 
+#ifndef CFG_VLN_PASTE
+#define CFG_VLN_PASTE 0
+#endif
+
+/*!< ms a paste may stall before it ends without its end marker */
+#ifndef CFG_VLN_PASTE_TIMEOUT
+#define CFG_VLN_PASTE_TIMEOUT 500
+#endif
+
+/*!< wrap a long line over rows instead of scrolling it in one row */
+#ifndef CFG_VLN_WRAP
+#define CFG_VLN_WRAP 0
+#endif
+
+/*!< tab completion, candidates listed in columns and paged by --More-- */
+#ifndef CFG_VLN_COMPLETE
+#define CFG_VLN_COMPLETE 0
+#endif
+
+/*!< headless line intake for scripted input, nothing echoed or drawn */
+#ifndef CFG_VLN_HEADLESS
+#define CFG_VLN_HEADLESS 0
+#endif
+
+/*!< undo and redo, edits journaled in an arena given to vln_init */
+#ifndef CFG_VLN_UNDO
+#define CFG_VLN_UNDO 0
+#endif
+
+/*!< pager for long command output on the alternate screen */
+#ifndef CFG_VLN_PAGER
+#define CFG_VLN_PAGER 0
+#endif
+
+/*!< longest pager search pattern */
+#ifndef CFG_VLN_PAGER_PATTERN
+#define CFG_VLN_PAGER_PATTERN 32
+#endif
+
+/*!< status row on the bottom terminal row, below a scroll region */
+#ifndef CFG_VLN_STATUS
+#define CFG_VLN_STATUS 0
+#endif
+
+/*!< shortest ms between two status redraws, needs a tick */
+#ifndef CFG_VLN_STATUS_INTERVAL
+#define CFG_VLN_STATUS_INTERVAL 100
+#endif
+
+/*!< crc checked request and response frames for host tools, mixed
+     with the interactive input */
+#ifndef CFG_VLN_FRAME
+#define CFG_VLN_FRAME 0
+#endif
+
+/*!< ms between two bytes of a frame before it is dropped, needs a tick */
+#ifndef CFG_VLN_FRAME_TIMEOUT
+#define CFG_VLN_FRAME_TIMEOUT 500
+#endif
+
+/*!< lines longer than the line buffer go to a callback in chunks */
+#ifndef CFG_VLN_STREAM
+#define CFG_VLN_STREAM 0
+#endif
+
+/*!< bytes requested per sget call, 0 reads one byte at a time */
+#ifndef CFG_VLN_RXBUF
+#define CFG_VLN_RXBUF 0
+#endif
+
+#if CFG_VLN_RXBUF > 255
+#error "CFG_VLN_RXBUF must not exceed 255"
+#endif
+
+#ifndef CFG_VLN_DETECT_TIMEOUT
+#define CFG_VLN_DETECT_TIMEOUT 500
+#endif
+
+/*!< output profile until detection picks one, VLN_TERM_DUMB, _VT100 or _XTERM */
+#ifndef CFG_VLN_TERM
+#define CFG_VLN_TERM VLN_TERM_XTERM
+#endif
+
+/*!< cycle probes feeding per stage log2 histograms, see vln_probe */
+#ifndef CFG_VLN_PROBE
+#define CFG_VLN_PROBE 0
+#endif
+
+/*!< histogram buckets, the last one also counts everything longer */
+#ifndef CFG_VLN_PROBE_BUCKETS
+#define CFG_VLN_PROBE_BUCKETS 24
+#endif
+
+#if CFG_VLN_PROBE_BUCKETS > 32
+#error "CFG_VLN_PROBE_BUCKETS must not exceed 32"
+#endif
+
+/*!< ms after esc or a partial sequence before it is taken as a key */
+#ifndef CFG_VLN_ESC_TIMEOUT
+#define CFG_VLN_ESC_TIMEOUT 50
+#endif
+
+#define VLN_PNS_MAX 4 /*!< max number of csi params */
+
+#define VLN_WAIT_FOREVER UINT32_MAX /*!< wait timeout with no deadline */
+
+#define VLN_FRAME_OVERHEAD 11 /*!< frame bytes besides the payload */
+
+#define VLN_SGR_MAX 64 /*!< buffer for the longest sgr sequence and \0 */
+
+/*!< vln_sgr_t colour from the 256 colour palette, or 24 bit rgb */
+#define VLN_SGR_INDEX(__n) (0x1000000u | (uint8_t)(__n))
+#define VLN_SGR_RGB(__r, __g, __b)                                   \
+    (0x2000000u | ((uint32_t)(uint8_t)(__r) << 16) |                 \
+     ((uint32_t)(uint8_t)(__g) << 8) | (uint32_t)(uint8_t)(__b))
+
 #ifndef CFG_VLN_NEWLINE
 #define CFG_VLN_NEWLINE "\r\n"
 #endif
@@ -101,11 +255,126 @@ enum {
     VLN_SGR_DEFAULT = 10
 };
 
+/*!< colours a terminal shows, fewer are approximated */
+enum {
+    VLN_COLORS_AUTO = 0, /*!< by profile, 8 on vt100 and 256 on xterm */
+    VLN_COLORS_8,        /*!< basic colours                          */
+    VLN_COLORS_256,      /*!< xterm 256 colour palette               */
+    VLN_COLORS_TRUE,     /*!< 24 bit rgb                             */
+};
+
+/*!< terminal type, also selects the output profile */
+enum {
+    VLN_TERM_UNKNOWN = 0, /*!< detection pending or not started */
+    VLN_TERM_DUMB,        /*!< no reply before detection timeout, CR BS and spaces */
+    VLN_TERM_VT100,       /*!< replied device attributes or cpr, no CHA or ECH */
+    VLN_TERM_XTERM,       /*!< replied text area size */
+};
+
+/*!< frame types and error codes, an error frame carries the code */
+enum {
+    VLN_FRAME_REQUEST = 'q',  /*!< host to vln            */
+    VLN_FRAME_RESPONSE = 'r', /*!< vln to host            */
+    VLN_FRAME_ERROR = 'e',    /*!< vln to host, no answer */
+};
+
+enum {
+    VLN_FRAME_ECRC = 1, /*!< crc or terminator wrong    */
+    VLN_FRAME_ESIZE,    /*!< payload larger than buffer */
+    VLN_FRAME_ETYPE,    /*!< not a request              */
+    VLN_FRAME_ETIME,    /*!< stalled, dropped           */
+};
+
+/*!< stream chunk flags */
+enum {
+    VLN_STREAM_MORE = 0, /*!< a full buffer, the line goes on    */
+    VLN_STREAM_END,      /*!< the rest, the line was entered     */
+    VLN_STREAM_ABORT,    /*!< no data, the line was aborted      */
+};
+
+/*!< headless mode */
+enum {
+    VLN_HEADLESS_OFF = 0, /*!< interactive editing                    */
+    VLN_HEADLESS_ON,      /*!< lines split as they arrive, no echo    */
+    VLN_HEADLESS_AUTO,    /*!< turns on when detection gets no reply  */
+};
+
+/*!< probed stages, each stage counts its own cycles without nested ones */
+enum {
+    VLN_PROBE_PARSE = 0, /*!< escape sequence parse and key dispatch */
+    VLN_PROBE_EDIT,      /*!< edit op                               */
+    VLN_PROBE_HLOAD,     /*!< history load                          */
+    VLN_PROBE_HSTORE,    /*!< history store                         */
+    VLN_PROBE_RENDER,    /*!< line refresh                          */
+    VLN_PROBE_OUTPUT,    /*!< sput calls                            */
+    VLN_PROBE_MAX
+};
+
+typedef struct {
+    char key;   /*!< placeholder key, written as %key in template */
+    void *arg;  /*!< callback argument */
+    uint8_t (*poll)(void *arg); /*!< nonzero if value changed, NULL if static */
+    uint16_t (*render)(void *arg, char *buf, uint16_t size); /*!< return length */
+} vln_pptvar_t;
+
+typedef struct {
+    uint16_t off; /*!< span start offset */
+    uint16_t len; /*!< span length       */
+    uint64_t sgr; /*!< span attributes   */
+} vln_span_t;
+
+/*!< output gathered for one sput, NULL pbuf sends straight out */
+typedef struct {
+    char *pbuf;    /*!< staging buffer    */
+    uint16_t size; /*!< buffer size       */
+    uint16_t len;  /*!< bytes in buffer   */
+} vln_stage_t;
+
+/*!< highlight callback, rescan line from *from which may be moved back to
+     a token start, fill spans sorted by offset inside [*from, size), text
+     without span is plain, return span count */
+typedef uint8_t (*vln_highlight_t)(void *arg, const char *line, uint16_t size,
+                                   uint16_t *from, vln_span_t *spans, uint8_t max);
+
+/*!< frame callback, data holds the request payload of len bytes, write
+     the response payload over it, up to size bytes, and return its
+     length */
+typedef uint16_t (*vln_frame_t)(void *arg, uint8_t *data, uint16_t len, uint16_t size);
+
+/*!< stream callback, takes the chunks of a line that outgrew the line
+     buffer, data is only valid during the call */
+typedef void (*vln_stream_t)(void *arg, const char *data, uint16_t len, uint8_t flag);
+
+/*!< completion callback, return candidate n of those starting with word,
+     NULL past the last one, n counts up from 0 or from the first
+     candidate of a page, strings must stay valid until NULL is returned */
+typedef const char *(*vln_complete_t)(void *arg, const char *word, uint16_t len, uint16_t n);
+
+/*!< pager source, return line n of the output and its size in *size,
+     NULL past the last line, lines are asked for in any order and a line
+     is only used until the next call, so one scratch buffer will do */
+typedef const char *(*vln_pager_t)(void *arg, uint32_t n, uint16_t *size);
+
+/*!< shared history log, see vln_share.h */
+struct vln_share;
+
+/*!< suggestion prefix index, element n holds three things: the record of
+     the entry in slot n, the slot at sorted position n, and tree node n
+     over sorted positions */
+typedef struct {
+    uint16_t end;  /*!< history position after line */
+    uint16_t size; /*!< line size */
+    uint16_t sort; /*!< slot at this sorted position */
+    uint16_t best; /*!< newest slot under this tree node */
+} vln_histidx_t;
+
 typedef struct
 {
     char *prompt; /*!< prompt pointer */
     uint16_t (*sput)(void *, uint16_t);
     uint16_t (*sget)(void *, uint16_t);
+    uint32_t (*tick)(void); /*!< monotonic millisecond tick, optional */
+    void (*wait)(uint32_t); /*!< sleep until input or timeout ms, optional */
 
     struct
     {
@@ -120,8 +389,75 @@ typedef struct
         uint16_t lnmax;  /*!< linebuff max  */
         uint16_t curoff; /*!< cursor offset */
         uint16_t mask;   /*!< line mask     */
+        uint16_t dirty;  /*!< first changed offset  */
+        uint16_t winoff; /*!< visible window offset */
+        uint16_t drawn;  /*!< visible size on screen */
+        uint16_t cursor; /*!< screen cursor column  */
+#if defined(CFG_VLN_PASTE) && CFG_VLN_PASTE
+        uint16_t paste;  /*!< inside bracketed paste, 2 after CR */
+        uint16_t pfrom;  /*!< paste start offset    */
+        uint16_t ptail;  /*!< bytes after cursor parked at linebuff end */
+        uint32_t ptick;  /*!< latest paste byte     */
+#endif
+#if defined(CFG_VLN_WRAP) && CFG_VLN_WRAP
+        uint8_t wrap;    /*!< line laid out over rows */
+#endif
     } ln;
 
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+    struct
+    {
+        vln_highlight_t cb;                /*!< highlight callback  */
+        void *arg;                         /*!< callback argument   */
+        uint8_t nspan;                     /*!< span count          */
+        vln_span_t spans[CFG_VLN_HLSPAN];  /*!< spans on screen     */
+    } hl;
+#endif
+
+#if defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE
+    struct
+    {
+        vln_complete_t cb; /*!< completion callback */
+        void *arg;         /*!< callback argument   */
+        vln_stage_t out;   /*!< listing staging     */
+        uint16_t word;     /*!< word start offset   */
+        uint16_t count;    /*!< candidate count     */
+        uint16_t next;     /*!< next to list, 0 when not paging */
+        uint16_t width;    /*!< widest candidate    */
+        uint16_t cols;     /*!< candidates per row  */
+    } cpl;
+#endif
+
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+    struct
+    {
+        vln_pager_t cb;  /*!< source, NULL when not paging */
+        void *arg;       /*!< source argument      */
+        vln_stage_t out; /*!< output staging       */
+        uint32_t top;    /*!< line on the first row */
+        uint32_t end;    /*!< line count, UINT32_MAX until known */
+        uint16_t rows;   /*!< text rows drawn for  */
+        uint8_t scr;     /*!< alternate screen with a scroll region */
+        uint8_t find;    /*!< typing a pattern     */
+        uint8_t miss;    /*!< last search failed   */
+        uint8_t plen;    /*!< pattern size         */
+        uint8_t slen;    /*!< status size, erased on a dumb terminal */
+        char pat[CFG_VLN_PAGER_PATTERN]; /*!< search pattern */
+    } pgr;
+#endif
+
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+    struct
+    {
+        char *shown;    /*!< cells on screen, NULL without status row */
+        char *next;     /*!< cells to show        */
+        uint16_t width; /*!< cells per buffer     */
+        uint16_t row;   /*!< terminal rows, with the status row */
+        uint8_t dirty;  /*!< next differs from shown */
+        uint32_t tick;  /*!< latest redraw        */
+    } sts;
+#endif
+
     struct
     {
         union {
@@ -131,10 +467,109 @@ typedef struct
                 uint8_t alt;   /*!< is screen alt buffer */
             };
         };
-        uint16_t row; /*!< terminal row     */
-        uint16_t col; /*!< terminal column  */
+        uint16_t row;   /*!< terminal row     */
+        uint16_t col;   /*!< terminal column  */
+        uint8_t type;   /*!< terminal type    */
+        uint8_t detect; /*!< detect pending   */
+        uint32_t dtick; /*!< detect start     */
     } term;
 
+    struct
+    {
+        uint64_t cur;   /*!< attributes on screen */
+        uint8_t colors; /*!< VLN_COLORS_*, set by vln_colors */
+    } sgr;
+
+    struct
+    {
+        uint8_t state;             /*!< escape parser state  */
+        uint8_t expre;             /*!< csi private prefix   */
+        uint8_t npn;               /*!< csi param index      */
+        uint16_t pns[VLN_PNS_MAX]; /*!< csi params           */
+        uint32_t tick;             /*!< latest sequence byte */
+    } seq;
+
+#if defined(CFG_VLN_FRAME) && CFG_VLN_FRAME
+    struct
+    {
+        vln_frame_t cb; /*!< frame callback, NULL to ignore frames */
+        void *arg;      /*!< callback argument   */
+        uint8_t *pbuf;  /*!< frame buffer        */
+        uint16_t size;  /*!< frame buffer size   */
+        uint8_t skip;   /*!< dropping input to a terminator */
+        uint8_t last;   /*!< previous byte while dropping */
+        uint32_t len;   /*!< bytes after intro   */
+        uint32_t need;  /*!< frame bytes after intro, 0 until known */
+    } frm;
+#endif
+
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+    struct
+    {
+        vln_stream_t cb; /*!< stream callback, NULL to drop the excess */
+        void *arg;       /*!< callback argument    */
+        uint8_t on;      /*!< line is streaming    */
+    } stm;
+#endif
+
+#if defined(CFG_VLN_UNDO) && CFG_VLN_UNDO
+    struct
+    {
+        uint8_t *pbuf; /*!< journal arena           */
+        uint16_t size; /*!< arena size              */
+        uint16_t top;  /*!< end of records          */
+        uint16_t cur;  /*!< end of applied records  */
+        uint8_t merge; /*!< last record takes typing */
+    } undo;
+#endif
+
+#if defined(CFG_VLN_HEADLESS) && CFG_VLN_HEADLESS
+    struct
+    {
+        uint8_t mode;  /*!< headless mode             */
+        uint8_t cr;    /*!< last line ended with CR   */
+        uint8_t skip;  /*!< dropping an overlong line */
+        char *pbuf;    /*!< linebuff holding input    */
+        uint16_t off;  /*!< next line start           */
+        uint16_t len;  /*!< input end                 */
+        uint16_t scan; /*!< scanned up to             */
+    } hdl;
+#endif
+
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+    struct
+    {
+        uint32_t (*cycles)(void); /*!< cycle counter, NULL stops probes */
+        uint32_t child;           /*!< cycles of nested stages          */
+        uint32_t hist[VLN_PROBE_MAX][CFG_VLN_PROBE_BUCKETS]; /*!< log2 buckets */
+    } probe;
+#endif
+
+#if defined(CFG_VLN_RXBUF) && CFG_VLN_RXBUF
+    struct
+    {
+        uint8_t off;                 /*!< next byte          */
+        uint8_t len;                 /*!< bytes in buffer    */
+        uint8_t pbuf[CFG_VLN_RXBUF]; /*!< last sget result   */
+    } rx;
+#endif
+
+    struct
+    {
+        uint8_t dirty; /*!< prompt need recalculate */
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+        uint8_t nvars;              /*!< placeholder count       */
+        uint8_t shown;              /*!< right segment on screen */
+        uint16_t size;              /*!< render half size        */
+        uint16_t rptlen;            /*!< right segment strlen    */
+        uint16_t rptoff;            /*!< right segment width     */
+        uint32_t tick;              /*!< last placeholder poll   */
+        const char *tmpl;           /*!< template pointer        */
+        const vln_pptvar_t *vars;   /*!< placeholders            */
+        char *pbuf;                 /*!< render half not shown   */
+#endif
+    } ppt;
+
 #if defined(CFG_VLN_HISTORY) && CFG_VLN_HISTORY
     struct {
         char *pbuf;     /*!< histfifo buffer  */
@@ -144,31 +579,61 @@ typedef struct
         uint16_t size;  /*!< histfifo size    */
         uint16_t cache; /*!< history cache    */
         uint16_t index; /*!< history index    */
+#if defined(CFG_VLN_SHARE) && CFG_VLN_SHARE
+        struct vln_share *share; /*!< shared log, NULL if private only */
+        uint32_t seq;            /*!< shared line shown   */
+#endif
     } hist;
 #endif
 
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+    struct {
+        vln_histidx_t *pidx; /*!< prefix index            */
+        uint16_t in;         /*!< index fifo in pos       */
+        uint16_t out;        /*!< index fifo out pos      */
+        uint16_t mask;       /*!< index fifo mask         */
+        uint16_t hit;        /*!< suggested entry         */
+        uint16_t len;        /*!< prefix size of hit      */
+        uint16_t lo;         /*!< sorted run of prefix    */
+        uint16_t hi;         /*!< sorted run end          */
+        uint16_t drawn;      /*!< entry on screen         */
+        uint16_t from;       /*!< line size when drawn    */
+        uint16_t shown;      /*!< suggestion on screen    */
+    } sug;
+#endif
+
 } vln_t;
 
 typedef struct {
     char *prompt;      /*!< prompt buffer pointer */
-    char *history;     /*!< history buffer pointer */
+    char *history;     /*!< history buffer pointer, NULL to disable */
     uint32_t histsize; /*!< history buffer size, must be a power of 2 */
+    struct vln_share *share; /*!< shared history log, NULL for private only */
+    vln_histidx_t *histidx; /*!< suggestion prefix index, NULL to disable */
+    uint16_t idxsize;       /*!< prefix index count, must be a power of 2 */
+    char *undo;             /*!< undo journal arena, NULL to disable */
+    uint16_t undosize;      /*!< arena size, 8 bytes per record plus text */
     uint16_t (*sput)(void *, uint16_t);
     uint16_t (*sget)(void *, uint16_t);
+    uint32_t (*tick)(void); /*!< monotonic millisecond tick, optional */
+    void (*wait)(uint32_t); /*!< sleep until input or timeout ms, optional */
 } vln_init_t;
 
 typedef struct
 {
     union {
-        uint16_t raw;
+        uint64_t raw;
         struct
         {
-            uint16_t foreground : 6;
-            uint16_t bold       : 1;
-            uint16_t underline  : 1;
-            uint16_t background : 6;
-            uint16_t blink      : 1;
-            uint16_t inverse    : 1;
+            uint32_t foreground : 26; /*!< VLN_SGR_*, VLN_SGR_INDEX or VLN_SGR_RGB */
+            uint32_t bold       : 1;
+            uint32_t dim        : 1;
+            uint32_t italic     : 1;
+            uint32_t underline  : 1;
+            uint32_t blink      : 1;
+            uint32_t inverse    : 1;
+            uint32_t background : 26; /*!< as foreground */
+            uint32_t            : 6;
         };
     };
 } vln_sgr_t;
@@ -202,9 +667,44 @@ extern int vln_init(vln_t *vln, vln_init_t *init);
 extern char *vln(vln_t *vln, char *linebuff, uint32_t buffsize, uint32_t *linesize);
 extern char *vln_isr(vln_t *vln, char *linebuff, uint32_t buffsize, uint32_t *linesize);
 extern void vln_detect(vln_t *vln);
-extern void vln_sgrset(char *buf, size_t *idx, uint16_t sgrraw);
+extern uint32_t vln_timeout(vln_t *vln);
+extern void vln_resize(vln_t *vln, uint16_t row, uint16_t col);
+extern void vln_term(vln_t *vln, uint8_t type);
+#if defined(CFG_VLN_HEADLESS) && CFG_VLN_HEADLESS
+extern void vln_headless(vln_t *vln, uint8_t mode);
+#endif
+#if defined(CFG_VLN_PROBE) && CFG_VLN_PROBE
+extern void vln_probe(vln_t *vln, uint32_t (*cycles)(void));
+extern const uint32_t *vln_probe_hist(vln_t *vln, uint8_t stage);
+#endif
+extern void vln_sgrset(char *buf, size_t *idx, uint64_t sgrraw);
+extern void vln_sgrdelta(vln_t *vln, char *buf, size_t *idx, uint64_t sgrraw);
+extern void vln_colors(vln_t *vln, uint8_t colors);
 extern void vln_clear(vln_t *vln);
 extern void vln_mask(vln_t *vln, uint8_t mask);
+extern void vln_prompt_update(vln_t *vln);
+#if defined(CFG_VLN_HIGHLIGHT) && CFG_VLN_HIGHLIGHT
+extern void vln_highlight(vln_t *vln, vln_highlight_t cb, void *arg);
+#endif
+#if defined(CFG_VLN_COMPLETE) && CFG_VLN_COMPLETE
+extern void vln_complete(vln_t *vln, vln_complete_t cb, void *arg, char *buf, uint16_t size);
+#endif
+#if defined(CFG_VLN_PAGER) && CFG_VLN_PAGER
+extern int vln_pager(vln_t *vln, vln_pager_t cb, void *arg, char *buf, uint16_t size);
+#endif
+#if defined(CFG_VLN_STATUS) && CFG_VLN_STATUS
+extern int vln_status(vln_t *vln, char *buf, uint16_t size);
+extern int vln_status_update(vln_t *vln, const char *text, uint16_t len);
+#endif
+#if defined(CFG_VLN_FRAME) && CFG_VLN_FRAME
+extern void vln_frame(vln_t *vln, vln_frame_t cb, void *arg, char *buf, uint16_t size);
+#endif
+#if defined(CFG_VLN_STREAM) && CFG_VLN_STREAM
+extern void vln_stream(vln_t *vln, vln_stream_t cb, void *arg);
+#endif
+#if defined(CFG_VLN_PROMPT) && CFG_VLN_PROMPT
+extern int vln_prompt(vln_t *vln, const char *tmpl, const vln_pptvar_t *vars, uint8_t nvars, char *buf, uint16_t size);
+#endif
 /*---------------------------------------------------------------------------
 * @}            vln_functions functions
 ----------------------------------------------------------------------------*/
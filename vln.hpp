@@ -0,0 +1,376 @@
+/*****************************************************************************
+* @file         vln.hpp
+* @brief        header-only C++20 front-end, policy configured editors and
+*               co_await a line without blocking a thread
+*
+*   using factory = vlnpp::editor<64, 0>;
+*   using service = vlnpp::editor<256, 2048, vlnpp::history, vlnpp::suggest<32>>;
+*
+*   vlnpp::session<service> con{[&](std::string_view out) { sock.send(out); }};
+*
+*   task console(vlnpp::session<> &con) {
+*       for (;;) {
+*           std::string line = co_await con.readline();
+*           ...
+*       }
+*   }
+*
+*   // on read readiness, from the executor
+*   con.feed(std::string_view(buf, n));
+*
+* A session never reads by itself. Bytes handed to feed() run through
+* vln_isr(), and the coroutine waiting in readline() is resumed from
+* inside feed() once a line completes, so any number of sessions can share
+* one executor thread. Bytes after the line stay buffered until the next
+* readline(), which is when the next prompt is printed.
+*
+* The awaiter is a plain C++20 awaitable, usable from any coroutine type
+* that accepts foreign awaitables.
+*
+* Sizes are checked with static_assert and the buffers live in the editor
+* object, so an editor needs no allocation and no runtime size checks.
+* Editors with different policies can coexist in one image.
+*
+* Policies are not compile-time feature switches. vln.c is built once with
+* the CFG_VLN_* switches and shared by every editor, a policy turns on a
+* compiled-in feature for one instance. A feature left out costs no
+* storage, but its code stays in the image and the C editing loop is not
+* specialised for the template sizes. Turn a CFG_VLN_* switch off to drop
+* the code.
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.02.25
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+#ifndef __vln_hpp__
+#define __vln_hpp__
+
+/* includes ----------------------------------------------------------------*/
+#include <array>
+#include <chrono>
+#include <climits>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "vln.h"
+
+namespace vlnpp {
+
+namespace detail {
+
+/*!< session being served by this thread, vln callbacks carry no context */
+struct io {
+    std::function<void(std::string_view)> *write;
+    std::string *rx;
+    std::size_t *rxoff;
+};
+
+inline thread_local io current{};
+
+inline std::uint16_t sput(void *buf, std::uint16_t size)
+{
+    if (current.write && *current.write) {
+        (*current.write)(std::string_view(static_cast<const char *>(buf), size));
+    }
+    return size;
+}
+
+inline std::uint16_t sget(void *buf, std::uint16_t size)
+{
+    std::size_t left;
+
+    if (nullptr == current.rx) {
+        return 0;
+    }
+
+    left = current.rx->size() - *current.rxoff;
+    if (size > left) {
+        size = static_cast<std::uint16_t>(left);
+    }
+
+    current.rx->copy(static_cast<char *>(buf), size, *current.rxoff);
+    *current.rxoff += size;
+    return size;
+}
+
+inline std::uint32_t tick()
+{
+    using namespace std::chrono;
+    return static_cast<std::uint32_t>(
+        duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+/*!< binds the thread local io to a session for one call into vln */
+class scope {
+public:
+    explicit scope(const io &next) : prev_(current) { current = next; }
+    ~scope() { current = prev_; }
+    scope(const scope &) = delete;
+    scope &operator=(const scope &) = delete;
+
+private:
+    io prev_;
+};
+
+} // namespace detail
+
+/** @defgroup   vlnpp_policies policies
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/*!< keep history in HistBytes of ring buffer */
+struct history {};
+
+/*!< history autosuggestions with an index of N entries */
+template <std::size_t N>
+struct suggest {
+    static constexpr std::size_t entries = N;
+};
+
+/*!< start with masked input, for password prompts */
+struct masked {};
+
+/*!< query terminal type and size when the editor is created */
+struct detect {};
+
+/*---------------------------------------------------------------------------
+* @}            vlnpp_policies policies
+----------------------------------------------------------------------------*/
+
+namespace detail {
+
+template <class T, class... Ps>
+inline constexpr bool has = (std::is_same_v<T, Ps> || ...);
+
+template <class T>
+struct suggest_entries : std::integral_constant<std::size_t, 0> {};
+
+template <std::size_t N>
+struct suggest_entries<suggest<N>> : std::integral_constant<std::size_t, N> {};
+
+template <class... Ps>
+inline constexpr std::size_t suggest_of = (std::size_t{0} + ... + suggest_entries<Ps>::value);
+
+constexpr bool pow2(std::size_t n) { return (n >= 2) && !(n & (n - 1)); }
+
+/*!< storage that disappears when N is 0 */
+template <class T, std::size_t N>
+struct storage {
+    alignas(4) std::array<T, N> buf{};
+    T *data() { return buf.data(); }
+};
+
+template <class T>
+struct storage<T, 0> {
+    T *data() { return nullptr; }
+};
+
+} // namespace detail
+
+/*****************************************************************************
+* @brief        editor with its buffers, sizes checked at compile time
+* 
+* @tparam       LineMax     line buffer bytes, 5 are reserved for size and \0
+* @tparam       HistBytes   history ring bytes, power of 2, 0 without history
+* @tparam       Policies    history, suggest<N>, masked, detect
+*****************************************************************************/
+template <std::size_t LineMax, std::size_t HistBytes, class... Policies>
+class editor {
+public:
+    static constexpr bool has_history = detail::has<history, Policies...>;
+    static constexpr std::size_t suggest_entries = detail::suggest_of<Policies...>;
+
+    static_assert(LineMax > 5, "LineMax must leave room for size and terminator");
+    static_assert(LineMax <= UINT16_MAX + 5ul, "LineMax exceeds 16 bit line offsets");
+    static_assert(!has_history || detail::pow2(HistBytes), "HistBytes must be a power of 2");
+    static_assert(!has_history || (HistBytes <= 32768), "HistBytes exceeds 16 bit ring positions");
+    static_assert(has_history || (HistBytes == 0), "HistBytes needs the history policy");
+    static_assert(!has_history || CFG_VLN_HISTORY, "vln.c is built without CFG_VLN_HISTORY");
+    static_assert((suggest_entries == 0) || has_history, "suggest needs the history policy");
+    static_assert((suggest_entries == 0) || detail::pow2(suggest_entries),
+                  "suggest entries must be a power of 2");
+#if !(defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST)
+    static_assert(suggest_entries == 0, "vln.c is built without CFG_VLN_SUGGEST");
+#endif
+
+    static constexpr std::size_t line_max = LineMax;
+
+    editor(std::uint16_t (*sput)(void *, std::uint16_t), std::uint16_t (*sget)(void *, std::uint16_t),
+           const char *prompt = "> ", std::uint32_t (*tick)(void) = detail::tick)
+    {
+        vln_init_t init{};
+        init.prompt = const_cast<char *>(prompt);
+        init.history = hist_.data();
+        init.histsize = HistBytes;
+#if defined(CFG_VLN_SUGGEST) && CFG_VLN_SUGGEST
+        init.histidx = idx_.data();
+        init.idxsize = suggest_entries;
+#endif
+        init.sput = sput;
+        init.sget = sget;
+        init.tick = tick;
+
+        /*!< sizes are checked above, this can not fail */
+        vln_init(&vln_, &init);
+
+        if constexpr (detail::has<masked, Policies...>) {
+            vln_mask(&vln_, 1);
+        }
+        if constexpr (detail::has<detect, Policies...>) {
+            vln_detect(&vln_);
+        }
+    }
+
+    editor(const editor &) = delete;
+    editor &operator=(const editor &) = delete;
+
+    vln_t &native() { return vln_; }
+
+    /*!< blocking readline, NULL on error */
+    const char *readline(std::uint32_t *size) { return vln(&vln_, line_.data(), LineMax, size); }
+
+    /*!< non-blocking readline, NULL until a line completes */
+    const char *poll(std::uint32_t *size) { return vln_isr(&vln_, line_.data(), LineMax, size); }
+
+private:
+    vln_t vln_;
+    alignas(4) std::array<char, LineMax> line_{};
+    detail::storage<char, HistBytes> hist_;
+    detail::storage<vln_histidx_t, suggest_entries> idx_;
+};
+
+/*****************************************************************************
+* @brief        one console driven by feed(), owns an editor, pinned in memory
+*****************************************************************************/
+template <class Editor = editor<256, 1024, history>>
+class session {
+public:
+    using writer = std::function<void(std::string_view)>;
+
+    explicit session(writer write, const char *prompt = "> ")
+        : write_(std::move(write)), ed_(construct(this, prompt))
+    {
+    }
+
+    session(const session &) = delete;
+    session &operator=(const session &) = delete;
+
+    vln_t &native() { return ed_.native(); }
+
+    /*!< send terminal queries, replies are parsed from fed bytes */
+    void detect()
+    {
+        detail::scope s(io());
+        vln_detect(&ed_.native());
+    }
+
+    void resize(std::uint16_t row, std::uint16_t col)
+    {
+        detail::scope s(io());
+        vln_resize(&ed_.native(), row, col);
+    }
+
+    /*****************************************************************************
+    * @brief        hand received bytes to the editor, resumes the waiting
+    *               readline() if they complete a line
+    *****************************************************************************/
+    void feed(std::string_view bytes)
+    {
+        rx_.append(bytes);
+        pump();
+    }
+
+    class line_awaiter {
+    public:
+        explicit line_awaiter(session &s) : s_(s) {}
+
+        bool await_ready()
+        {
+            s_.pump();
+            return s_.ready_;
+        }
+
+        void await_suspend(std::coroutine_handle<> h) { s_.waiter_ = h; }
+
+        std::string await_resume()
+        {
+            s_.ready_ = false;
+            return std::move(s_.line_);
+        }
+
+    private:
+        session &s_;
+    };
+
+    /*!< co_await to get the next line, one waiter at a time */
+    line_awaiter readline() { return line_awaiter(*this); }
+
+private:
+    detail::io io() { return detail::io{&write_, &rx_, &rxoff_}; }
+
+    /*!< editor policies may output at construction, bind io first */
+    static Editor construct(session *self, const char *prompt)
+    {
+        detail::scope s(self->io());
+        return Editor(detail::sput, detail::sget, prompt);
+    }
+
+    void pump()
+    {
+        std::uint32_t size;
+        const char *line;
+
+        if (ready_) {
+            return;
+        }
+
+        {
+            detail::scope s(io());
+            line = ed_.poll(&size);
+        }
+
+        /*!< drop consumed bytes once in a while, not per key */
+        if ((rxoff_ == rx_.size()) || (rxoff_ > 4096)) {
+            rx_.erase(0, rxoff_);
+            rxoff_ = 0;
+        }
+
+        if (nullptr == line) {
+            return;
+        }
+
+        line_.assign(line, size);
+        ready_ = true;
+
+        if (waiter_) {
+            std::exchange(waiter_, {}).resume();
+        }
+    }
+
+    bool ready_ = false;
+    writer write_;
+    std::string rx_;
+    std::size_t rxoff_ = 0;
+    std::string line_;
+    std::coroutine_handle<> waiter_;
+    Editor ed_;
+};
+
+} // namespace vlnpp
+
+#endif
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
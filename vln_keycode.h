@@ -372,6 +372,12 @@ enum {
     VLN_EXEC_F10,     /*!< Fucntion 10               */
     VLN_EXEC_F11,     /*!< Fucntion 11               */
     VLN_EXEC_F12,     /*!< Fucntion 12               */
+    VLN_EXEC_PSBG,    /*!< Bracketed paste begin     */
+    VLN_EXEC_PSED,    /*!< Bracketed paste end       */
+    VLN_EXEC_UNDO,    /*!< Undo last edit            */
+    VLN_EXEC_REDO,    /*!< Redo undone edit          */
+    VLN_EXEC_PGUP,    /*!< Page up                   */
+    VLN_EXEC_PGDN,    /*!< Page down                 */
 };
 /*---------------------------------------------------------------------------
 * @}            vln_types types
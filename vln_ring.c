@@ -0,0 +1,217 @@
+/*****************************************************************************
+* @file         vln_ring.c
+* @brief        lock-free single producer single consumer byte ring
+*
+*   uart isr                      vln sget
+*   vln_ring_write(&rx, &c, 1)    return vln_ring_read(&rx, buf, size);
+*
+* The producer only stores in and the consumer only stores out, each with
+* release order after touching the data, and loads the other index with
+* acquire order. No interrupt masking or lock is needed as long as there
+* is exactly one producer and one consumer. Indices run freely and wrap at
+* 2^32, the size is a power of 2 so the fill level is in - out.
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.02.25
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <string.h>
+#include "vln_ring.h"
+
+/* private functions -------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        copy into ring at free running position, handles wrap
+*****************************************************************************/
+static void vln_ring_copyin(vln_ring_t *ring, uint32_t pos, const uint8_t *src, uint32_t size)
+{
+    uint32_t off = pos & ring->mask;
+    uint32_t first = ring->mask + 1 - off;
+
+    if (first > size) {
+        first = size;
+    }
+
+    memcpy(ring->pbuf + off, src, first);
+    memcpy(ring->pbuf, src + first, size - first);
+}
+
+/*****************************************************************************
+* @brief        copy out of ring at free running position, handles wrap
+*****************************************************************************/
+static void vln_ring_copyout(vln_ring_t *ring, uint32_t pos, uint8_t *dst, uint32_t size)
+{
+    uint32_t off = pos & ring->mask;
+    uint32_t first = ring->mask + 1 - off;
+
+    if (first > size) {
+        first = size;
+    }
+
+    memcpy(dst, ring->pbuf + off, first);
+    memcpy(dst + first, ring->pbuf, size - first);
+}
+
+/* exported functions ------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        init ring
+*
+* @param[in]    ring
+* @param[in]    buf         ring buffer
+* @param[in]    size        buffer size, must be a power of 2
+*
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+int vln_ring_init(vln_ring_t *ring, void *buf, uint32_t size)
+{
+    if ((NULL == ring) || (NULL == buf) || (size < 2) || (size & (size - 1))) {
+        return -1;
+    }
+
+    ring->pbuf = buf;
+    ring->mask = size - 1;
+    atomic_init(&ring->in, 0);
+    atomic_init(&ring->out, 0);
+    atomic_init(&ring->overrun, 0);
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        producer writes a block, bytes that do not fit are dropped
+*               and counted as overrun
+*
+* @param[in]    ring
+* @param[in]    buf         data, a whole dma block or a single byte
+* @param[in]    size        data size
+*
+* @retval uint32_t          bytes written
+*****************************************************************************/
+uint32_t vln_ring_write(vln_ring_t *ring, const void *buf, uint32_t size)
+{
+    uint32_t in = atomic_load_explicit(&ring->in, memory_order_relaxed);
+    uint32_t out = atomic_load_explicit(&ring->out, memory_order_acquire);
+    uint32_t space = ring->mask + 1 - (in - out);
+
+    if (size > space) {
+        /*!< producer is the only writer, no read-modify-write needed */
+        atomic_store_explicit(&ring->overrun,
+                              atomic_load_explicit(&ring->overrun, memory_order_relaxed) + size - space,
+                              memory_order_relaxed);
+        size = space;
+    }
+
+    vln_ring_copyin(ring, in, buf, size);
+    atomic_store_explicit(&ring->in, in + size, memory_order_release);
+
+    return size;
+}
+
+/*****************************************************************************
+* @brief        producer gets contiguous free space, for dma to write in
+*               place, finish with vln_ring_commit
+*
+* @param[in]    ring
+* @param[out]   span        free space pointer
+*
+* @retval uint32_t          contiguous free size
+*****************************************************************************/
+uint32_t vln_ring_wspan(vln_ring_t *ring, uint8_t **span)
+{
+    uint32_t in = atomic_load_explicit(&ring->in, memory_order_relaxed);
+    uint32_t out = atomic_load_explicit(&ring->out, memory_order_acquire);
+    uint32_t space = ring->mask + 1 - (in - out);
+    uint32_t first = ring->mask + 1 - (in & ring->mask);
+
+    *span = ring->pbuf + (in & ring->mask);
+    return (space < first) ? space : first;
+}
+
+/*****************************************************************************
+* @brief        producer publishes bytes written into vln_ring_wspan
+*
+* @param[in]    ring
+* @param[in]    size        bytes written, must not exceed span size
+*****************************************************************************/
+void vln_ring_commit(vln_ring_t *ring, uint32_t size)
+{
+    uint32_t in = atomic_load_explicit(&ring->in, memory_order_relaxed);
+
+    atomic_store_explicit(&ring->in, in + size, memory_order_release);
+}
+
+/*****************************************************************************
+* @brief        consumer reads up to size bytes, signature fits vln sget
+*               through a one line wrapper
+*
+* @param[in]    ring
+* @param[out]   buf
+* @param[in]    size        buffer size
+*
+* @retval uint32_t          bytes read
+*****************************************************************************/
+uint32_t vln_ring_read(vln_ring_t *ring, void *buf, uint32_t size)
+{
+    uint32_t out = atomic_load_explicit(&ring->out, memory_order_relaxed);
+    uint32_t in = atomic_load_explicit(&ring->in, memory_order_acquire);
+
+    if (size > (in - out)) {
+        size = in - out;
+    }
+
+    vln_ring_copyout(ring, out, buf, size);
+    atomic_store_explicit(&ring->out, out + size, memory_order_release);
+
+    return size;
+}
+
+/*****************************************************************************
+* @brief        consumer gets contiguous readable data without copy,
+*               finish with vln_ring_skip
+*
+* @param[in]    ring
+* @param[out]   span        data pointer
+*
+* @retval uint32_t          contiguous readable size
+*****************************************************************************/
+uint32_t vln_ring_rspan(vln_ring_t *ring, const uint8_t **span)
+{
+    uint32_t out = atomic_load_explicit(&ring->out, memory_order_relaxed);
+    uint32_t in = atomic_load_explicit(&ring->in, memory_order_acquire);
+    uint32_t first = ring->mask + 1 - (out & ring->mask);
+
+    *span = ring->pbuf + (out & ring->mask);
+    return ((in - out) < first) ? (in - out) : first;
+}
+
+/*****************************************************************************
+* @brief        consumer releases bytes got from vln_ring_rspan
+*
+* @param[in]    ring
+* @param[in]    size        bytes consumed, must not exceed span size
+*****************************************************************************/
+void vln_ring_skip(vln_ring_t *ring, uint32_t size)
+{
+    uint32_t out = atomic_load_explicit(&ring->out, memory_order_relaxed);
+
+    atomic_store_explicit(&ring->out, out + size, memory_order_release);
+}
+
+/*****************************************************************************
+* @brief        bytes dropped by producer since init
+*****************************************************************************/
+uint32_t vln_ring_overrun(vln_ring_t *ring)
+{
+    return atomic_load_explicit(&ring->overrun, memory_order_relaxed);
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
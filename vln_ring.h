@@ -0,0 +1,77 @@
+/*****************************************************************************
+* @file         vln_ring.h
+* @brief        lock-free single producer single consumer byte ring, fed by
+*               uart isr or dma and read by vln sget in bulk
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.02.25
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+* @htmlonly
+* <span style='font-weight: bold'>History</span>
+* @endhtmlonly
+* Version|Author|Date|Biref
+* ----|----|----|----
+* 1.0|Egahp|2023.02.25|Create
+*****************************************************************************/
+
+#ifndef __vln_ring_h__
+#define __vln_ring_h__
+
+/* includes ----------------------------------------------------------------*/
+#include <stdatomic.h>
+#include <stdint.h>
+
+/** @addtogroup vln_ring
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/** @defgroup   vln_ring_types types
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+typedef struct {
+    uint8_t *pbuf;             /*!< ring buffer                       */
+    uint32_t mask;             /*!< size - 1                          */
+    _Atomic uint32_t in;       /*!< written by producer only          */
+    _Atomic uint32_t out;      /*!< written by consumer only          */
+    _Atomic uint32_t overrun;  /*!< bytes dropped, written by producer only */
+} vln_ring_t;
+/*---------------------------------------------------------------------------
+* @}            vln_ring_types types
+----------------------------------------------------------------------------*/
+
+/** @defgroup   vln_ring_functions functions
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+extern int vln_ring_init(vln_ring_t *ring, void *buf, uint32_t size);
+
+/*!< producer side, isr safe */
+extern uint32_t vln_ring_write(vln_ring_t *ring, const void *buf, uint32_t size);
+extern uint32_t vln_ring_wspan(vln_ring_t *ring, uint8_t **span);
+extern void vln_ring_commit(vln_ring_t *ring, uint32_t size);
+
+/*!< consumer side */
+extern uint32_t vln_ring_read(vln_ring_t *ring, void *buf, uint32_t size);
+extern uint32_t vln_ring_rspan(vln_ring_t *ring, const uint8_t **span);
+extern void vln_ring_skip(vln_ring_t *ring, uint32_t size);
+
+extern uint32_t vln_ring_overrun(vln_ring_t *ring);
+/*---------------------------------------------------------------------------
+* @}            vln_ring_functions functions
+----------------------------------------------------------------------------*/
+
+/**
+* @}
+*/
+
+#endif
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
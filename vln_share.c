@@ -0,0 +1,258 @@
+/*****************************************************************************
+* @file         vln_share.c
+* @brief        lock-free multi producer history log shared by vln sessions
+*
+*   session A                         session B
+*   vln_share_append(&log, l, n)      n = vln_share_next(&log)
+*                                     vln_share_read(&log, n - 1, ...)
+*
+* A record is an 8 byte header {seq, len} and the line, padded to 4 bytes,
+* in a byte arena that wraps and overwrites the oldest records. A producer
+* takes a sequence number and arena bytes with one fetch_add each, writes
+* the record, then publishes its position in the slot of its sequence
+* number with release order. Producers never wait for each other.
+*
+* Readers take nothing and store nothing. They read the slot, copy the
+* record, then load the reserved head again. If a producer has reserved
+* bytes that reach the record, it may have been overwritten while copied
+* and is reported gone, like a seqlock reader retrying. A sequence number
+* taken but not yet published reads as missing and is skipped. So does a
+* line whose slot was overwritten late by a producer that stalled for a
+* whole lap of the slot table, and one whose slot points at reused bytes.
+*
+* The arena is read and written as relaxed atomic words, so a reader
+* copying a record a producer overwrites is a checked race and not
+* undefined behaviour. Appends take two atomic fetch_add. That is lock-free
+* on cores with exclusive loads and stores, but becomes a library call on
+* a Cortex-M0 and similar, which is safe between threads but only safe
+* from an interrupt if that call masks interrupts.
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.02.25
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+*****************************************************************************/
+
+/* includes ----------------------------------------------------------------*/
+#include <string.h>
+#include "vln_share.h"
+
+/* private typedef ---------------------------------------------------------*/
+typedef struct {
+    uint32_t seq;  /*!< sequence number      */
+    uint16_t len;  /*!< line size            */
+    uint16_t rsv;  /*!< reserved             */
+} vln_share_hdr_t;
+
+/* private functions -------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        copy into arena at free running position a word at a time,
+*               the last word is padded. records start on a word, so the
+*               wrap falls between two words
+*****************************************************************************/
+static void vln_share_copyin(vln_share_t *share, uint32_t pos, const void *src, uint32_t size)
+{
+    const uint8_t *p = src;
+    uint32_t n;
+    uint32_t w;
+
+    for (; size; pos += 4) {
+        n = (size < 4) ? size : 4;
+        w = 0;
+        memcpy(&w, p, n);
+        atomic_store_explicit(&share->pbuf[(pos & share->mask) >> 2], w, memory_order_relaxed);
+        p += n;
+        size -= n;
+    }
+}
+
+/*****************************************************************************
+* @brief        copy out of arena at free running position a word at a time,
+*               a producer may be storing the same words, which is why every
+*               access is atomic
+*****************************************************************************/
+static void vln_share_copyout(vln_share_t *share, uint32_t pos, void *dst, uint32_t size)
+{
+    uint8_t *p = dst;
+    uint32_t n;
+    uint32_t w;
+
+    for (; size; pos += 4) {
+        n = (size < 4) ? size : 4;
+        w = atomic_load_explicit(&share->pbuf[(pos & share->mask) >> 2], memory_order_relaxed);
+        memcpy(p, &w, n);
+        p += n;
+        size -= n;
+    }
+}
+
+/*****************************************************************************
+* @brief        check bytes from pos on were not reserved again since copied
+*****************************************************************************/
+static int vln_share_intact(vln_share_t *share, uint32_t pos)
+{
+    /*!< copies above may not move below the head load */
+    atomic_thread_fence(memory_order_acquire);
+
+    return (atomic_load_explicit(&share->head, memory_order_relaxed) - pos) <= (share->mask + 1);
+}
+
+/* exported functions ------------------------------------------------------*/
+
+/*****************************************************************************
+* @brief        init log
+*
+* @param[in]    share
+* @param[in]    buf         record arena, 4 byte aligned
+* @param[in]    size        arena size in bytes, must be a power of 2
+* @param[in]    slot        slot table, one per line the log can index
+* @param[in]    count       slot count, must be a power of 2
+*
+* @retval int               0:Success -1:Error
+*****************************************************************************/
+int vln_share_init(vln_share_t *share, void *buf, uint32_t size, vln_share_slot_t *slot, uint32_t count)
+{
+    uint32_t i;
+
+    if ((NULL == share) || (NULL == buf) || ((uintptr_t)buf & 3) || (NULL == slot) ||
+        (size < 16) || (size & (size - 1)) || (count < 2) || (count & (count - 1))) {
+        return -1;
+    }
+
+    share->pbuf = buf;
+    share->mask = size - 1;
+    share->slot = slot;
+    share->smask = count - 1;
+
+    /*!< slot and header of no record match sequence 0 */
+    for (i = 0; i < count; i++) {
+        atomic_init(&slot[i], 0);
+    }
+    for (i = 0; i < size / 4; i++) {
+        atomic_init(&share->pbuf[i], UINT32_MAX);
+    }
+
+    atomic_init(&share->head, 0);
+    atomic_init(&share->seq, 0);
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        append a line, overwrites the oldest records when the arena
+*               is full
+*
+* @param[in]    share
+* @param[in]    line
+* @param[in]    len         line size
+*
+* @retval int               0:Success -1:Error, longer than the arena
+*****************************************************************************/
+int vln_share_append(vln_share_t *share, const char *line, uint16_t len)
+{
+    vln_share_hdr_t hdr;
+    uint32_t total = (sizeof(hdr) + len + 3u) & ~3u;
+    uint32_t pos;
+
+    if (total > (share->mask + 1)) {
+        return -1;
+    }
+
+    hdr.seq = atomic_fetch_add_explicit(&share->seq, 1, memory_order_relaxed);
+    hdr.len = len;
+    hdr.rsv = 0;
+
+    pos = atomic_fetch_add_explicit(&share->head, total, memory_order_relaxed);
+
+    /*!< readers see the reservation before any byte it covers changes */
+    atomic_thread_fence(memory_order_release);
+
+    vln_share_copyin(share, pos, &hdr, sizeof(hdr));
+    vln_share_copyin(share, pos + sizeof(hdr), line, len);
+
+    atomic_store_explicit(&share->slot[hdr.seq & share->smask], pos, memory_order_release);
+
+    return 0;
+}
+
+/*****************************************************************************
+* @brief        sequence number after the newest line, a cursor starts here
+*               and reads backwards for older lines
+*
+* @param[in]    share
+*
+* @retval uint32_t          next sequence number
+*****************************************************************************/
+uint32_t vln_share_next(vln_share_t *share)
+{
+    return atomic_load_explicit(&share->seq, memory_order_acquire);
+}
+
+/*****************************************************************************
+* @brief        read the line of a sequence number
+*
+* @param[in]    share
+* @param[in]    seq         sequence number, below vln_share_next
+* @param[out]   buf         line, cut to size, NULL only checks the line
+* @param[in]    size        buffer size
+* @param[out]   len         line size, or bytes copied to buf
+*
+* @retval int               0:Success
+*                           1:Missing, still being appended or its slot
+*                             no longer tells, try older or newer lines
+*                           -1:Gone, overwritten by newer lines or not
+*                             below vln_share_next, buf may hold a part
+*                             of an overwritten line
+*****************************************************************************/
+int vln_share_read(vln_share_t *share, uint32_t seq, char *buf, uint16_t size, uint16_t *len)
+{
+    uint32_t next = atomic_load_explicit(&share->seq, memory_order_acquire);
+    uint32_t back = next - seq;
+    vln_share_hdr_t hdr;
+    uint32_t pos;
+
+    /*!< not taken yet, before the first line, or the slot may already
+         serve a newer line */
+    if ((back == 0) || (back > next) || (back > (share->smask + 1))) {
+        return -1;
+    }
+
+    pos = atomic_load_explicit(&share->slot[seq & share->smask], memory_order_acquire);
+    vln_share_copyout(share, pos, &hdr, sizeof(hdr));
+
+    /*!< the slot may still point at the record of an older line, whose
+         bytes are reused, while seq is taken but not yet published. that
+         cannot be told from seq itself being overwritten, so it is not
+         called gone: a walk goes on and ends at the slot table bound */
+    if (!vln_share_intact(share, pos)) {
+        return 1;
+    }
+
+    if (hdr.seq != seq) {
+        /*!< an older line in the slot, seq is not published yet */
+        return ((int32_t)(hdr.seq - seq) < 0) ? 1 : -1;
+    }
+
+    if (NULL != buf) {
+        if (hdr.len > size) {
+            hdr.len = size;
+        }
+
+        vln_share_copyout(share, pos + sizeof(hdr), buf, hdr.len);
+
+        if (!vln_share_intact(share, pos)) {
+            return -1;
+        }
+    }
+
+    *len = hdr.len;
+    return 0;
+}
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/
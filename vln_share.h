@@ -0,0 +1,77 @@
+/*****************************************************************************
+* @file         vln_share.h
+* @brief        lock-free multi producer history log shared by vln sessions,
+*               appended by every session and read by each through its own
+*               sequence number cursor
+*
+* @author       Egahp
+* @version      1.0
+* @date         2023.02.25
+******************************************************************************
+* @attention
+*
+* <h2><center>&copy; Copyright 2021 Egahp.
+* All rights reserved.</center></h2>
+*
+* @htmlonly
+* <span style='font-weight: bold'>History</span>
+* @endhtmlonly
+* Version|Author|Date|Biref
+* ----|----|----|----
+* 1.0|Egahp|2023.02.25|Create
+*****************************************************************************/
+
+#ifndef __vln_share_h__
+#define __vln_share_h__
+
+/* includes ----------------------------------------------------------------*/
+#include <stdatomic.h>
+#include <stdint.h>
+
+/** @addtogroup vln_share
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+
+/** @defgroup   vln_share_types types
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+typedef _Atomic uint32_t vln_share_slot_t;
+
+typedef struct vln_share {
+    _Atomic uint32_t *pbuf;  /*!< record arena in words               */
+    uint32_t mask;           /*!< arena size - 1                      */
+    vln_share_slot_t *slot;  /*!< arena position of each sequence     */
+    uint32_t smask;          /*!< slot count - 1                      */
+    _Atomic uint32_t head;   /*!< arena bytes reserved                */
+    _Atomic uint32_t seq;    /*!< next sequence number                */
+} vln_share_t;
+/*---------------------------------------------------------------------------
+* @}            vln_share_types types
+----------------------------------------------------------------------------*/
+
+/** @defgroup   vln_share_functions functions
+-----------------------------------------------------------------------------
+* @{
+----------------------------------------------------------------------------*/
+extern int vln_share_init(vln_share_t *share, void *buf, uint32_t size, vln_share_slot_t *slot, uint32_t count);
+
+/*!< any number of producers, thread safe, isr safe where 32 bit
+     fetch_add is lock-free, see vln_share.c */
+extern int vln_share_append(vln_share_t *share, const char *line, uint16_t len);
+
+/*!< any number of readers, each with its own cursor */
+extern uint32_t vln_share_next(vln_share_t *share);
+extern int vln_share_read(vln_share_t *share, uint32_t seq, char *buf, uint16_t size, uint16_t *len);
+/*---------------------------------------------------------------------------
+* @}            vln_share_functions functions
+----------------------------------------------------------------------------*/
+
+/**
+* @}
+*/
+
+#endif
+
+/************************ (C) COPYRIGHT 2021 Egahp **** END OF FILE *********/